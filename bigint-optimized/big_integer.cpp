@@ -1,16 +1,66 @@
 #include "big_integer.h"
+#include "limbs.h"
 
 #include <string>
 #include <stdexcept>
 #include <iostream>
 #include <cstddef>
 #include <iosfwd>
-#include <sstream>
 #include <algorithm>
 #include <tuple>
 #include <vector>
+#include <deque>
 #include <limits>
 #include <utility>
+#include <cctype>
+#include <cstring>
+
+const size_t big_integer::INLINE_LIMBS;
+
+// largest power of ten in a limb, decimal text is converted by chunks of that many digits
+#ifdef BIG_INTEGER_64BIT_LIMBS
+static const big_integer::int_t DECIMAL_BASE = 10000000000000000000ull;
+static const size_t DECIMAL_DIGITS = 19;
+#else
+static const big_integer::int_t DECIMAL_BASE = 1000000000;
+static const size_t DECIMAL_DIGITS = 9;
+#endif
+
+// log2(base) for power of two bases up to 32, 0 for decimal, throws for the rest
+static unsigned radix_bits(int base) {
+    for (unsigned bits = 1; bits <= 5; bits++) {
+        if (base == 1 << bits) {
+            return bits;
+        }
+    }
+    if (base != 10) {
+        throw std::runtime_error("Unsupported base for big_integer: " + std::to_string(base));
+    }
+    return 0;
+}
+
+// value of a digit in bases up to 36, 36 for anything else
+static int digit_value(char c) {
+    if ('0' <= c && c <= '9') {
+        return c - '0';
+    }
+    if ('a' <= c && c <= 'z') {
+        return c - 'a' + 10;
+    }
+    if ('A' <= c && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    return 36;
+}
+
+// mag |= value << pos, mag must have room for the set bits of value
+static void put_bits(scratch_vector<big_integer::int_t>& mag, size_t pos, big_integer::int_t value) {
+    size_t offset = pos % big_integer::INT_T_BITS;
+    mag[pos / big_integer::INT_T_BITS] |= value << offset;
+    if (offset != 0 && (value >> (big_integer::INT_T_BITS - offset)) != 0) {
+        mag[pos / big_integer::INT_T_BITS + 1] |= value >> (big_integer::INT_T_BITS - offset);
+    }
+}
 
 big_integer::big_integer()
     : values(1, 0) {}
@@ -18,6 +68,16 @@ big_integer::big_integer()
 big_integer::big_integer(big_integer const& other)
     : values(other.values) {}
 
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+big_integer::big_integer(big_integer const& other, memory_resource* resource)
+    : values(other.values, resource) {}
+#endif
+
+big_integer::big_integer(big_integer&& other) noexcept
+    : big_integer() {
+    swap(other);
+}
+
 big_integer::big_integer(int a)
     : values((std::numeric_limits<int>::digits + INT_T_BITS) / INT_T_BITS, 0) {
     int copy = a;
@@ -43,33 +103,84 @@ big_integer::big_integer(int_t a)
 }
 
 big_integer::big_integer(std::string const& str)
+    : big_integer(str, 10) {}
+
+big_integer::big_integer(std::string const& str, int base)
     : big_integer() {
     if (str.empty()) {
         throw std::runtime_error("Empty string argument for big_integer(string)");
     }
 
-    for (size_t i = str[0] == '-' || str[0] == '+' ? 1 : 0; i < str.size(); i++) {
-        if (str[i] < '0' || '9' < str[i]) {
+    unsigned bits = radix_bits(base);
+    size_t first = str[0] == '-' || str[0] == '+' ? 1 : 0;
+    for (size_t i = first; i < str.size(); i++) {
+        if (digit_value(str[i]) >= base) {
             std::string msg = "Invalid character for string integer: ";
             msg.push_back(str[i]);
             throw std::runtime_error(msg);
         }
-        *this *= big_integer(int_t(10));
-        *this += str[i] - '0';
     }
 
-    if (str.data()[0] == '-') {
+    if (bits == 0) {
+        // chunks of DECIMAL_DIGITS digits, the first one is shorter
+        size_t len = (str.size() - first) % DECIMAL_DIGITS;
+        scratch_vector<int_t> chunks;
+        for (size_t i = first; i < str.size(); i += len, len = DECIMAL_DIGITS) {
+            if (len == 0) {
+                len = DECIMAL_DIGITS;
+            }
+            int_t chunk = 0;
+            for (size_t j = i; j < i + len; j++) {
+                chunk = chunk * 10 + static_cast<int_t>(str[j] - '0');
+            }
+            chunks.push_back(chunk);
+        }
+        *this = from_decimal(chunks.data(), chunks.data() + chunks.size());
+    } else {
+        // every digit is a group of bits, from the lowest one
+        scratch_vector<int_t> mag(((str.size() - first) * bits + INT_T_BITS - 1) / INT_T_BITS, 0);
+        size_t pos = 0;
+        for (size_t i = str.size(); i > first; i--, pos += bits) {
+            put_bits(mag, pos, static_cast<int_t>(digit_value(str[i - 1])));
+        }
+        assign_magnitude(mag, false);
+    }
+
+    if (str[0] == '-') {
         negate();
     }
 }
 
+#ifdef BIG_INTEGER_MMAP_STORAGE
+void big_integer::save(std::string const& path) const {
+    mmap_buffer<int_t>::save(path, &values[0], size());
+}
+
+big_integer big_integer::load(std::string const& path) {
+    size_t size;
+    mmap_buffer<int_t>* buf = mmap_buffer<int_t>::map_file(path, size);
+    big_integer res;
+    res.values = storage_t(buf, size);
+    return res;
+}
+#endif
+
 big_integer& big_integer::operator=(big_integer const& other)  {
     values = other.values;
     return *this;
 }
 
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+big_integer& big_integer::operator=(big_integer&& other) {
+#else
+big_integer& big_integer::operator=(big_integer&& other) noexcept {
+#endif
+    values = std::move(other.values);
+    return *this;
+}
+
 big_integer& big_integer::sum_with(big_integer const& rhs, size_t my_offset, int_t carry) {
-    values.resize(std::max(rhs.size() + my_offset, size() + 1), get_rest());
+    values.resize(std::max(rhs.size() + my_offset, size()) + 1, get_rest());
 
     for (size_t i = my_offset; i < size() - 1; i++) {
         values[i] += carry;
@@ -97,33 +208,49 @@ big_integer& big_integer::operator-=(big_integer const& rhs) {
     return sum_with(~rhs, 1);
 }
 
-big_integer& big_integer::diff_with(big_integer const& rhs, size_t my_offset) {
-    return sum_with(~rhs, my_offset, 1);
+big_integer& big_integer::operator*=(big_integer const& rhs) {
+    bool was_neg = is_negative() != rhs.is_negative();
+    scratch_vector<int_t> a = magnitude();
+    scratch_vector<int_t> b = rhs.magnitude();
+    if (a.empty() || b.empty()) {
+        return *this = 0;
+    }
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+    }
+
+    scratch_vector<int_t> res(a.size() + b.size());
+    if (a == b) {
+        // covers both x *= x and x * x, where rhs is a copy of *this
+        limbs::sqr(res.data(), a.data(), a.size());
+    } else {
+        limbs::mul(res.data(), a.data(), a.size(), b.data(), b.size());
+    }
+    return assign_magnitude(res, was_neg);
 }
 
-big_integer& big_integer::operator*=(big_integer const& rhs) {
-    const big_integer rhs_copy = rhs.is_negative() ? -rhs : rhs;
-    const big_integer copy = is_negative() ? -*this : *this;
-    bool was_neg = (is_negative() + rhs.is_negative()) == 1;
-
-    values.assign(size() + rhs.size() + 1, 0);
-
-    for (size_t i = 0; i < copy.size(); i++) {
-        int_t carry = 0;
-        for (size_t j = i; j - i < rhs_copy.size() || (carry && j < size()); j++) {
-            double_int_t res = static_cast<double_int_t>(carry)
-                             + static_cast<double_int_t>(values[j]);
-            if (j - i < rhs_copy.size()) {
-                res += static_cast<double_int_t>(copy.values[i])
-                     * static_cast<double_int_t>(rhs_copy.get(j - i));
-            }
-            values[j] = static_cast<int_t>(res);
-            carry = static_cast<int_t>(res >> INT_T_BITS);
-        }
+big_integer& big_integer::square() {
+    scratch_vector<int_t> a = magnitude();
+    scratch_vector<int_t> res(2 * a.size());
+    limbs::sqr(res.data(), a.data(), a.size());
+    return assign_magnitude(res, false);
+}
+
+// *this must be a multiple of rhs, otherwise the result is unspecified
+big_integer& big_integer::divexact(big_integer const& rhs) {
+    bool was_neg = is_negative() != rhs.is_negative();
+    scratch_vector<int_t> a = magnitude();
+    scratch_vector<int_t> b = rhs.magnitude();
+    if (b.empty()) {
+        throw std::runtime_error("Division by zero");
+    }
+    if (a.size() < b.size()) {
+        return *this = 0;
     }
 
-    shrink_to_fit();
-    return was_neg ? this->negate() : *this;
+    scratch_vector<int_t> q(a.size() - b.size() + 1);
+    limbs::divexact(q.data(), a.data(), a.size(), b.data(), b.size());
+    return assign_magnitude(q, was_neg);
 }
 
 // *this >= 0, rhs >= 0
@@ -132,61 +259,124 @@ std::tuple<big_integer, big_integer::int_t> big_integer::divide(int_t rhs) {
         throw std::runtime_error("Division by zero");
     }
 
-    double_int_t carry = 0;
+    storage_t const& a = values;
     big_integer res = 0;
     res.values.assign(size(), 0);
-
-    for (size_t i = size(); i > 0; i--) {
-        carry = (carry << INT_T_BITS) + values[i - 1];
-        res.values[i - 1] = static_cast<int_t>(carry / rhs);
-        carry = carry % rhs;
-    }
+    int_t rem = limbs::divrem_1(&res.values[0], &a[0], size(), rhs);
     res.shrink_to_fit();
-    return {res, carry};
+    return {res, rem};
 }
 
-// r and d have 0 on back() ==> size >= 2, d > 0
-big_integer::int_t trial(big_integer const& r, big_integer const& d, size_t k) {
-    using qi = big_integer::quad_int_t;
-    int BITS = big_integer::INT_T_BITS;
+// this >= rhs > 0, Knuth division on magnitudes, Burnikel-Ziegler for large operands
+std::tuple<big_integer, big_integer> big_integer::long_divide(big_integer const& rhs) const {
+    scratch_vector<int_t> a = magnitude();
+    scratch_vector<int_t> b = rhs.magnitude();
+    scratch_vector<int_t> q(a.size() - b.size() + 1);
+    scratch_vector<int_t> r(b.size());
+    limbs::divrem(q.data(), r.data(), a.data(), a.size(), b.data(), b.size());
+
+    big_integer qb, rb;
+    qb.assign_magnitude(q, false);
+    rb.assign_magnitude(r, false);
+    return {qb, rb};
+}
 
-    qi r3 = (static_cast<qi>(r.get(k    )) << (BITS << 1))
-          | (static_cast<qi>(r.get(k - 1)) <<  BITS      )
-          |  static_cast<qi>(r.get(k - 2));
+// this >= 0
+size_t big_integer::bit_length() const {
+    size_t n = size();
+    while (n > 0 && values[n - 1] == 0) {
+        n--;
+    }
+    if (n == 0) {
+        return 0;
+    }
 
-    qi d2 = (static_cast<qi>(d.values[d.size() - 2]) << BITS)
-           | static_cast<qi>(d.values[d.size() - 3]);
-    return static_cast<big_integer::int_t>(std::min(r3 / d2, static_cast<qi>(big_integer::INT_T_MAX)));
+    size_t res = (n - 1) * INT_T_BITS;
+    for (int_t top = values[n - 1]; top != 0; top >>= 1) {
+        res++;
+    }
+    return res;
 }
 
-// this >= rhs > 0, this and rhs have 0 on back() ==> size >= 2
-std::tuple<big_integer, big_integer> big_integer::long_divide(big_integer const& rhs) {
-    int_t f = static_cast<int_t>(
-                    (static_cast<double_int_t>(1) << INT_T_BITS)
-                  / (static_cast<double_int_t>(rhs.values[rhs.size() - 2]) + 1)
-              );
-    big_integer r = (*this * f).push_zero();
-    big_integer d = (  rhs * f).push_zero();
-    big_integer q = 0;
-    q.values.assign(size() - rhs.size() + 1, 0);
-
-    for (size_t k = size() - rhs.size() + 1; k > 0; k--) {
-        int_t qt = trial(r, d, k + rhs.size() - 2);
-        big_integer dq = d * qt;
+// floor(2^(2k) / d) up to a few units for 2^(k-1) <= d < 2^k, plain division up to threshold limbs of the result
+big_integer big_integer::reciprocal(big_integer const& d, size_t k, size_t threshold) {
+    big_integer power = big_integer(1).shift_left(2 * k);
+    if (k <= threshold * INT_T_BITS / 2) {
+        return power / d;
+    }
 
-        if (dq.compare_to(r, k - 1) == 1) {
-            dq = d * --qt;
-        }
-        q.values[k - 1] = qt;
+    // reciprocal xh of the top h bits is correct in about h bits, Newton step doubles them:
+    // x = xh * 2^(k-h) + x * (2^(2k) - d * x) / 2^(2k), guard bits keep the error bounded
+    size_t h = k / 2 + 4;
+    big_integer xh = reciprocal(big_integer(d).shift_right(k - h), h, threshold);
+    big_integer e = d * xh;
+    e = power - e.shift_left(k - h);
+    e *= xh;
+    e.shift_right(k + h);
+    xh.shift_left(k - h);
+    xh += e;
+    return xh;
+}
 
-        r.diff_with(dq, k - 1);
-        r.push_zero();
+// this >= 0, rhs > 0, x = reciprocal of rhs scaled to k bits, the quotient has at most k - 3 bits
+std::tuple<big_integer, big_integer> big_integer::reciprocal_divide(big_integer const& rhs, big_integer const& x,
+                                                                    size_t k) const {
+    if (*this < rhs) {
+        return {0, *this};
     }
 
-    std::tie(r, std::ignore) = r.divide(f);
+    // q = a * x / 2^(2k) scaled by 2^(db-k), low bits of a change it by less than 1
+    size_t db = rhs.bit_length();
+    big_integer q(*this);
+    if (db >= 3) {
+        q.shift_right(db - 3);
+    } else {
+        q.shift_left(3 - db);
+    }
+    q *= x;
+    q.shift_right(k + 3);
+    big_integer r = *this - q * rhs;
+    while (r.is_negative()) {
+        --q;
+        r += rhs;
+    }
+    while (r >= rhs) {
+        ++q;
+        r -= rhs;
+    }
     return {q, r};
 }
 
+// this >= rhs > 0, Newton division by chunks of rhs size, so that every partial quotient fits into rhs size;
+// the reciprocal recursion stops at threshold limbs
+std::tuple<big_integer, big_integer> big_integer::newton_divide(big_integer const& rhs, size_t threshold) const {
+    scratch_vector<int_t> a = magnitude();
+    size_t m = rhs.magnitude().size();
+    scratch_vector<int_t> q(a.size(), 0);
+    big_integer r = 0;
+
+    // a partial quotient is below 2^(m * INT_T_BITS), so one reciprocal of that precision serves all chunks
+    size_t k = m * INT_T_BITS + 3;
+    big_integer x = reciprocal(big_integer(rhs).shift_left(k - rhs.bit_length()), k, threshold);
+
+    for (size_t chunk = (a.size() - 1) / m + 1; chunk > 0; chunk--) {
+        size_t lo = (chunk - 1) * m;
+        size_t hi = std::min(lo + m, a.size());
+        big_integer cur;
+        cur.assign_magnitude(scratch_vector<int_t>(a.begin() + lo, a.begin() + hi), false);
+        cur += r.shift_left((hi - lo) * INT_T_BITS);
+
+        big_integer qi;
+        std::tie(qi, r) = cur.reciprocal_divide(rhs, x, k);
+        scratch_vector<int_t> qm = qi.magnitude();
+        std::copy(qm.begin(), qm.end(), q.begin() + lo);
+    }
+
+    big_integer qb;
+    qb.assign_magnitude(q, false);
+    return {qb, r};
+}
+
 // this and rhs have 0 on back()
 std::tuple<big_integer, big_integer> big_integer::divide_positive(big_integer const& rhs) {
     if (rhs.size() <= 2) {
@@ -199,6 +389,9 @@ std::tuple<big_integer, big_integer> big_integer::divide_positive(big_integer co
     if (*this < rhs) {
         return {0, *this};
     }
+    if (rhs.size() > limbs::NEWTON_THRESHOLD && size() - rhs.size() > limbs::NEWTON_THRESHOLD) {
+        return newton_divide(rhs, limbs::NEWTON_THRESHOLD);
+    }
     return long_divide(rhs);
 }
 
@@ -245,17 +438,72 @@ std::tuple<big_integer, big_integer> big_integer::divide(big_integer rhs)  {
     }
 }
 
+// same signs as divide(big_integer): quotient is truncated, remainder has the sign of *this
+std::tuple<big_integer, big_integer> big_integer::divide(big_divisor const& rhs) const {
+    scratch_vector<int_t> a = magnitude();
+    size_t m = rhs.normalized.size();
+    if (a.size() < m) {
+        return {0, *this};
+    }
+
+    scratch_vector<int_t> q(a.size() - m + 1);
+    scratch_vector<int_t> r(m);
+    limbs::divrem_preinv(q.data(), r.data(), a.data(), a.size(),
+                         rhs.normalized.data(), m, rhs.shift, rhs.reciprocal.data());
+
+    big_integer qb, rb;
+    qb.assign_magnitude(q, is_negative() != rhs.d.is_negative());
+    rb.assign_magnitude(r, is_negative());
+    return {qb, rb};
+}
+
+big_divisor::big_divisor(big_integer const& d)
+    : d(d)
+    , shift(0)
+    , normalized(d.magnitude()) {
+    if (normalized.empty()) {
+        throw std::runtime_error("Division by zero");
+    }
+
+    while ((normalized.back() << shift) >> (big_integer::INT_T_BITS - 1) == 0) {
+        shift++;
+    }
+    if (shift != 0) {
+        limbs::lshift(normalized.data(), normalized.data(), normalized.size(), shift);
+    }
+    reciprocal.resize(normalized.size());
+    limbs::invert(reciprocal.data(), normalized.data(), normalized.size());
+}
+
+big_integer const& big_divisor::value() const {
+    return d;
+}
+
 big_integer& big_integer::operator/=(big_integer const& rhs) {
     big_integer res;
     std::tie(res, std::ignore) = divide(rhs);
-    swap(res);
+    *this = std::move(res);
     return *this;
 }
 
 big_integer& big_integer::operator%=(big_integer const& rhs) {
     big_integer res;
     std::tie(std::ignore, res) = divide(rhs);
-    swap(res);
+    *this = std::move(res);
+    return *this;
+}
+
+big_integer& big_integer::operator/=(big_divisor const& rhs) {
+    big_integer res;
+    std::tie(res, std::ignore) = divide(rhs);
+    *this = std::move(res);
+    return *this;
+}
+
+big_integer& big_integer::operator%=(big_divisor const& rhs) {
+    big_integer res;
+    std::tie(std::ignore, res) = divide(rhs);
+    *this = std::move(res);
     return *this;
 }
 
@@ -283,8 +531,11 @@ big_integer& big_integer::operator^=(big_integer const& rhs) {
     return bit_operation(rhs, [](big_integer::int_t a, big_integer::int_t b) { return a ^ b; });
 }
 
-big_integer& big_integer::operator<<=(int rhs_int) {
-    size_t rhs = static_cast<size_t>(rhs_int);
+big_integer& big_integer::operator<<=(int rhs) {
+    return shift_left(static_cast<size_t>(rhs));
+}
+
+big_integer& big_integer::shift_left(size_t rhs) {
     size_t blocks = rhs / INT_T_BITS;
     size_t in_block = rhs % INT_T_BITS;
     size_t out_block = INT_T_BITS - in_block;
@@ -306,8 +557,11 @@ big_integer& big_integer::operator<<=(int rhs_int) {
     return *this;
 }
 
-big_integer& big_integer::operator>>=(int rhs_int) {
-    size_t rhs = static_cast<size_t>(rhs_int);
+big_integer& big_integer::operator>>=(int rhs) {
+    return shift_right(static_cast<size_t>(rhs));
+}
+
+big_integer& big_integer::shift_right(size_t rhs) {
     size_t blocks = rhs / INT_T_BITS;
     size_t in_block = rhs % INT_T_BITS;
     size_t out_block = (INT_T_BITS - in_block) % INT_T_BITS;
@@ -330,11 +584,15 @@ big_integer big_integer::operator+() const {
 }
 
 big_integer big_integer::operator-() const {
-    return big_integer(*this).negate();
+    big_integer res(*this);
+    res.negate();
+    return res;
 }
 
 big_integer big_integer::operator~() const {
-    return big_integer(*this).negate_bits();
+    big_integer res(*this);
+    res.negate_bits();
+    return res;
 }
 
 big_integer& big_integer::operator++() {
@@ -381,80 +639,574 @@ bool operator>=(big_integer const& a, big_integer const& b) {
     return a.compare_to(b) >= 0;
 }
 
+// DECIMAL_BASE^(2^k), kept for later conversions in the same thread
+big_integer const& big_integer::decimal_power(size_t k) {
+    thread_local std::deque<big_integer> powers;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // the cache outlives any scoped resource
+    scoped_resource heap(nullptr);
+#endif
+    while (powers.size() <= k) {
+        if (powers.empty()) {
+            powers.push_back(big_integer(DECIMAL_BASE));
+        } else {
+            powers.push_back(powers.back());
+            powers.back().square();
+        }
+    }
+    return powers[k];
+}
+
+// decimal_power(k) with precomputed reciprocal
+big_divisor const& big_integer::decimal_divisor(size_t k) {
+    thread_local std::deque<big_divisor> divisors;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // the cache outlives any scoped resource
+    scoped_resource heap(nullptr);
+#endif
+    while (divisors.size() <= k) {
+        divisors.emplace_back(decimal_power(divisors.size()));
+    }
+    return divisors[k];
+}
+
+// value of the base DECIMAL_BASE digits in [first, last), the highest first
+big_integer big_integer::from_decimal(int_t const* first, int_t const* last) {
+    size_t len = static_cast<size_t>(last - first);
+    if (len <= limbs::DECIMAL_THRESHOLD) {
+        scratch_vector<int_t> mag;
+        for (int_t const* p = first; p != last; p++) {
+            int_t carry = limbs::muladd_1(mag.data(), mag.data(), mag.size(), DECIMAL_BASE, *p);
+            if (carry != 0) {
+                mag.push_back(carry);
+            }
+        }
+
+        big_integer res;
+        res.assign_magnitude(mag, false);
+        return res;
+    }
+
+    // high chunks times DECIMAL_BASE^(2^k) plus the low 2^k chunks
+    size_t k = 0;
+    while ((static_cast<size_t>(2) << k) < len) {
+        k++;
+    }
+    int_t const* mid = last - (static_cast<size_t>(1) << k);
+    big_integer res = from_decimal(first, mid);
+    res *= decimal_power(k);
+    res += from_decimal(mid, last);
+    return res;
+}
+
+// writes chunks * DECIMAL_DIGITS digits of 0 <= a < DECIMAL_BASE^chunks ending at last, leading zeros are kept
+void big_integer::to_decimal(big_integer const& a, size_t chunks, char* last) {
+    if (a.size() <= limbs::DECIMAL_THRESHOLD) {
+        scratch_vector<int_t> mag = a.magnitude();
+        for (size_t i = 0; i < chunks && !mag.empty(); i++) {
+            int_t chunk = limbs::divrem_1(mag.data(), mag.data(), mag.size(), DECIMAL_BASE);
+            if (mag.back() == 0) {
+                mag.pop_back();
+            }
+            for (size_t j = 0; j < DECIMAL_DIGITS; j++) {
+                *--last = static_cast<char>('0' + chunk % 10);
+                chunk /= 10;
+            }
+        }
+        return;
+    }
+
+    // low 2^k chunks are the remainder by DECIMAL_BASE^(2^k), the rest is the quotient
+    size_t k = 0;
+    while ((static_cast<size_t>(2) << k) < chunks) {
+        k++;
+    }
+    big_integer q, r;
+    std::tie(q, r) = a.divide(decimal_divisor(k));
+    to_decimal(r, static_cast<size_t>(1) << k, last);
+    to_decimal(q, chunks - (static_cast<size_t>(1) << k), last - (DECIMAL_DIGITS << k));
+}
+
 std::string to_string(big_integer const& a) {
-    std::stringstream ss;
-    ss << a;
-    return ss.str();
+    if (a == 0) {
+        return "0";
+    }
+
+    // a < 2^bits <= 10^(bits * log10(2)), rounded up to whole chunks
+    big_integer abs(a);
+    if (abs.is_negative()) {
+        abs.negate();
+    }
+    size_t chunks = abs.bit_length() * 30103 / 100000 / DECIMAL_DIGITS + 1;
+    std::string res(chunks * DECIMAL_DIGITS, '0');
+    big_integer::to_decimal(abs, chunks, &res[0] + res.size());
+    res.erase(0, res.find_first_not_of('0'));
+    if (a.is_negative()) {
+        res.insert(res.begin(), '-');
+    }
+    return res;
+}
+
+big_integer operator+(big_integer const& a, big_integer const& b) {
+    big_integer res(a);
+    res += b;
+    return res;
+}
+
+big_integer operator+(big_integer&& a, big_integer const& b) {
+    a += b;
+    return std::move(a);
 }
 
-big_integer operator+(big_integer a, big_integer const& b) {
-    return a += b;
+big_integer operator+(big_integer const& a, big_integer&& b) {
+    b += a;
+    return std::move(b);
+}
+
+big_integer operator+(big_integer&& a, big_integer&& b) {
+    if (a.values.capacity() < b.values.capacity()) {
+        a.swap(b);
+    }
+    a += b;
+    return std::move(a);
 }
 
 big_integer operator-(big_integer a, big_integer const& b) {
-    return a -= b;
+    a -= b;
+    return a;
+}
+
+big_integer operator-(big_integer const& a, big_integer&& b) {
+    b.negate() += a;
+    return std::move(b);
+}
+
+big_integer operator*(big_integer const& a, big_integer const& b) {
+    big_integer res(a);
+    res *= b;
+    return res;
+}
+
+big_integer operator*(big_integer&& a, big_integer const& b) {
+    a *= b;
+    return std::move(a);
 }
 
-big_integer operator*(big_integer a, big_integer const& b) {
-    return a *= b;
+big_integer operator*(big_integer const& a, big_integer&& b) {
+    b *= a;
+    return std::move(b);
+}
+
+big_integer operator*(big_integer&& a, big_integer&& b) {
+    if (a.values.capacity() < b.values.capacity()) {
+        a.swap(b);
+    }
+    a *= b;
+    return std::move(a);
 }
 
 big_integer operator/(big_integer a, big_integer const& b) {
-    return a /= b;
+    a /= b;
+    return a;
 }
 
 big_integer operator%(big_integer a, big_integer const& b) {
-    return a %= b;
+    a %= b;
+    return a;
+}
+
+big_integer operator/(big_integer a, big_divisor const& b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, big_divisor const& b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator&(big_integer const& a, big_integer const& b) {
+    big_integer res(a);
+    res &= b;
+    return res;
+}
+
+big_integer operator&(big_integer&& a, big_integer const& b) {
+    a &= b;
+    return std::move(a);
+}
+
+big_integer operator&(big_integer const& a, big_integer&& b) {
+    b &= a;
+    return std::move(b);
+}
+
+big_integer operator&(big_integer&& a, big_integer&& b) {
+    if (a.values.capacity() < b.values.capacity()) {
+        a.swap(b);
+    }
+    a &= b;
+    return std::move(a);
+}
+
+big_integer operator|(big_integer const& a, big_integer const& b) {
+    big_integer res(a);
+    res |= b;
+    return res;
+}
+
+big_integer operator|(big_integer&& a, big_integer const& b) {
+    a |= b;
+    return std::move(a);
+}
+
+big_integer operator|(big_integer const& a, big_integer&& b) {
+    b |= a;
+    return std::move(b);
+}
+
+big_integer operator|(big_integer&& a, big_integer&& b) {
+    if (a.values.capacity() < b.values.capacity()) {
+        a.swap(b);
+    }
+    a |= b;
+    return std::move(a);
 }
 
-big_integer operator&(big_integer a, big_integer const& b) {
-    return a &= b;
+big_integer operator^(big_integer const& a, big_integer const& b) {
+    big_integer res(a);
+    res ^= b;
+    return res;
 }
 
-big_integer operator|(big_integer a, big_integer const& b) {
-    return a |= b;
+big_integer operator^(big_integer&& a, big_integer const& b) {
+    a ^= b;
+    return std::move(a);
 }
 
-big_integer operator^(big_integer a, big_integer const& b) {
-    return a ^= b;
+big_integer operator^(big_integer const& a, big_integer&& b) {
+    b ^= a;
+    return std::move(b);
+}
+
+big_integer operator^(big_integer&& a, big_integer&& b) {
+    if (a.values.capacity() < b.values.capacity()) {
+        a.swap(b);
+    }
+    a ^= b;
+    return std::move(a);
 }
 
 big_integer operator<<(big_integer a, int b) {
-    return a <<= b;
+    a <<= b;
+    return a;
 }
 
 big_integer operator>>(big_integer a, int b) {
-    return a >>= b;
+    a >>= b;
+    return a;
 }
 
-std::ostream& operator<<(std::ostream& s, big_integer a) {
+std::string to_string(big_integer const& a, int base) {
+    unsigned bits = radix_bits(base);
+    if (bits == 0) {
+        return to_string(a);
+    }
     if (a == 0) {
-        return s << '0';
+        return "0";
     }
 
-    if (a.is_negative()) {
-        s << '-';
-        a.negate();
+    // every digit is a group of bits of the magnitude, from the lowest one
+    static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuv";
+    scratch_vector<big_integer::int_t> mag = a.magnitude();
+    size_t length = 0;
+    for (big_integer::int_t top = mag.back(); top != 0; top >>= 1) {
+        length++;
+    }
+    length = ((mag.size() - 1) * big_integer::INT_T_BITS + length + bits - 1) / bits;
+
+    std::string res(a.is_negative() + length, '-');
+    size_t pos = 0;
+    for (size_t i = res.size(); i > static_cast<size_t>(a.is_negative()); i--, pos += bits) {
+        size_t offset = pos % big_integer::INT_T_BITS;
+        big_integer::int_t digit = mag[pos / big_integer::INT_T_BITS] >> offset;
+        if (offset + bits > big_integer::INT_T_BITS && pos / big_integer::INT_T_BITS + 1 < mag.size()) {
+            digit |= mag[pos / big_integer::INT_T_BITS + 1] << (big_integer::INT_T_BITS - offset);
+        }
+        res[i - 1] = DIGITS[digit & ((1u << bits) - 1)];
     }
+    return res;
+}
 
-    std::string ans;
-    while (a > 0) {
-        big_integer q;
-        big_integer::int_t r;
-        std::tie(q, r) = a.divide(10);
-        a = q;
-        a.shrink_to_fit();
-        ans.push_back('0' + static_cast<char>(r));
+// reads an optional sign and the longest run of digits in the base of std::dec, std::hex or std::oct,
+// digits are packed into chunks while reading, without keeping the text
+std::istream& operator>>(std::istream& s, big_integer& a) {
+    std::istream::sentry sentry(s);
+    if (!sentry) {
+        return s;
     }
 
-    std::reverse(ans.begin(), ans.end());
-    for (auto e : ans) {
-        s << e;
+    std::ios_base::fmtflags basefield = s.flags() & std::ios_base::basefield;
+    int base = basefield == std::ios_base::hex ? 16 : (basefield == std::ios_base::oct ? 8 : 10);
+
+    std::streambuf* buf = s.rdbuf();
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    std::istream::int_type c = buf->sgetc();
+    bool negative = c == '-';
+    if (c == '-' || c == '+') {
+        c = buf->snextc();
     }
 
+    // like for built-in integers, hex digits may follow 0x or 0X, and without a basefield
+    // the prefix chooses the base: 0x for hex, 0 for octal
+    bool any = false;
+    if (c == '0' && (base == 16 || basefield == 0)) {
+        any = true;
+        c = buf->snextc();
+        if (c == 'x' || c == 'X') {
+            base = 16;
+            c = buf->snextc();
+        } else if (basefield == 0) {
+            base = 8;
+        }
+    }
+    unsigned bits = radix_bits(base);
+    size_t chunk_digits = bits == 0 ? DECIMAL_DIGITS : big_integer::INT_T_BITS / bits;
+
+    // full chunks, the highest first, and the last one with len digits
+    scratch_vector<big_integer::int_t> chunks;
+    big_integer::int_t chunk = 0;
+    big_integer::int_t power = 1;
+    size_t len = 0;
+    for (;; c = buf->snextc()) {
+        if (std::istream::traits_type::eq_int_type(c, std::istream::traits_type::eof())) {
+            state |= std::ios_base::eofbit;
+            break;
+        }
+        int digit = digit_value(std::istream::traits_type::to_char_type(c));
+        if (digit >= base) {
+            break;
+        }
+        any = true;
+        chunk = chunk * base + digit;
+        power *= base;
+        if (++len == chunk_digits) {
+            chunks.push_back(chunk);
+            chunk = 0;
+            power = 1;
+            len = 0;
+        }
+    }
+
+    if (!any) {
+        a = 0;
+        s.setstate(state | std::ios_base::failbit);
+        return s;
+    }
+
+    scratch_vector<big_integer::int_t> mag;
+    if (bits == 0) {
+        mag = big_integer::from_decimal(chunks.data(), chunks.data() + chunks.size()).magnitude();
+        big_integer::int_t carry = limbs::muladd_1(mag.data(), mag.data(), mag.size(), power, chunk);
+        if (carry != 0) {
+            mag.push_back(carry);
+        }
+    } else {
+        size_t chunk_bits = chunk_digits * bits;
+        mag.assign((chunks.size() * chunk_bits + len * bits) / big_integer::INT_T_BITS + 1, 0);
+        put_bits(mag, 0, chunk);
+        for (size_t i = 0; i < chunks.size(); i++) {
+            put_bits(mag, len * bits + (chunks.size() - 1 - i) * chunk_bits, chunks[i]);
+        }
+    }
+    a.assign_magnitude(mag, negative);
+    s.setstate(state);
     return s;
 }
 
+// std::hex and std::oct print the sign and the magnitude, std::showbase and std::uppercase work as for int
+std::ostream& operator<<(std::ostream& s, big_integer a) {
+    std::ios_base::fmtflags base = s.flags() & std::ios_base::basefield;
+    if (base != std::ios_base::hex && base != std::ios_base::oct) {
+        return s << to_string(a);
+    }
+
+    std::string res = to_string(a, base == std::ios_base::hex ? 16 : 8);
+    if (s.flags() & std::ios_base::uppercase) {
+        std::transform(res.begin(), res.end(), res.begin(), ::toupper);
+    }
+    if ((s.flags() & std::ios_base::showbase) && a != 0) {
+        std::string prefix = base == std::ios_base::oct ? "0" : (s.flags() & std::ios_base::uppercase ? "0X" : "0x");
+        res.insert(a.is_negative() ? 1 : 0, prefix);
+    }
+    return s << res;
+}
+
+size_t byte_length(big_integer const& a, size_t word_size) {
+    // high bytes that only repeat the sign are dropped
+    size_t n = a.size() * sizeof(big_integer::int_t);
+    unsigned char sign = a.is_negative() ? 0xff : 0;
+    while (n > 1 && a.get_byte(n - 1) == sign && (a.get_byte(n - 2) >> 7) == (sign & 1)) {
+        n--;
+    }
+    return (n + word_size - 1) / word_size * word_size;
+}
+
+bool to_bytes(big_integer const& a, void* out, size_t size, size_t word_size,
+              big_integer::endian word_order, big_integer::endian byte_order) {
+    if (word_size == 0 || size % word_size != 0) {
+        throw std::runtime_error("Byte size is not a multiple of the word size");
+    }
+    if (size < byte_length(a, word_size)) {
+        return false;
+    }
+
+    unsigned char* p = static_cast<unsigned char*>(out);
+    big_integer::int_t const* limbs = &a.values[0];
+    size_t limb_bytes = sizeof(big_integer::int_t);
+    size_t n = std::min(size, a.size() * limb_bytes);
+    unsigned char sign = a.is_negative() ? 0xff : 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (word_order == big_integer::endian::little && byte_order == big_integer::endian::little) {
+        // limbs are already in this layout
+        std::memcpy(p, limbs, n);
+        std::memset(p + n, sign, size - n);
+        return true;
+    }
+#endif
+
+    size_t words = size / word_size;
+    for (size_t w = 0; w < words; w++) {
+        unsigned char* word = p + (word_order == big_integer::endian::little ? w : words - 1 - w) * word_size;
+        for (size_t b = 0; b < word_size; b++) {
+            size_t i = w * word_size + b;
+            word[byte_order == big_integer::endian::little ? b : word_size - 1 - b] =
+                i < n ? static_cast<unsigned char>(limbs[i / limb_bytes] >> (8 * (i % limb_bytes))) : sign;
+        }
+    }
+    return true;
+}
+
+std::vector<unsigned char> to_bytes(big_integer const& a, size_t word_size,
+                                    big_integer::endian word_order, big_integer::endian byte_order) {
+    std::vector<unsigned char> res(byte_length(a, word_size));
+    to_bytes(a, res.data(), res.size(), word_size, word_order, byte_order);
+    return res;
+}
+
+big_integer from_bytes(void const* data, size_t size, size_t word_size,
+                       big_integer::endian word_order, big_integer::endian byte_order) {
+    if (word_size == 0 || size % word_size != 0) {
+        throw std::runtime_error("Byte size is not a multiple of the word size");
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    unsigned char const* p = static_cast<unsigned char const*>(data);
+    size_t limb_bytes = sizeof(big_integer::int_t);
+    big_integer res;
+    res.values.assign((size + limb_bytes - 1) / limb_bytes, 0);
+    big_integer::int_t* limbs = &res.values[0];
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (word_order == big_integer::endian::little && byte_order == big_integer::endian::little) {
+        std::memcpy(limbs, p, size);
+    } else
+#endif
+    {
+        size_t words = size / word_size;
+        for (size_t w = 0; w < words; w++) {
+            unsigned char const* word = p + (word_order == big_integer::endian::little ? w : words - 1 - w) * word_size;
+            for (size_t b = 0; b < word_size; b++) {
+                size_t i = w * word_size + b;
+                big_integer::int_t byte = word[byte_order == big_integer::endian::little ? b : word_size - 1 - b];
+                limbs[i / limb_bytes] |= byte << (8 * (i % limb_bytes));
+            }
+        }
+    }
+
+    // sign extension of the highest limb
+    if (size % limb_bytes != 0 && (limbs[size / limb_bytes] >> (8 * (size % limb_bytes) - 1)) != 0) {
+        limbs[size / limb_bytes] |= big_integer::INT_T_MAX << (8 * (size % limb_bytes));
+    }
+    res.shrink_to_fit();
+    return res;
+}
+
+void encode_varints(big_integer const* values, size_t count, std::vector<unsigned char>& out) {
+    for (size_t i = 0; i < count; i++) {
+        big_integer const& a = values[i];
+        uint64_t header = 0;
+        size_t bytes = 0;
+        size_t bits = a.size() * big_integer::INT_T_BITS;
+        if (bits <= 64) {
+            // limbs are read directly and sign extended from the top one
+            uint64_t v = 0;
+            for (size_t j = 0; j < a.size(); j++) {
+                v |= static_cast<uint64_t>(a.values[j]) << (j * big_integer::INT_T_BITS);
+            }
+            bool negative = bits != 0 && (v >> (bits - 1)) != 0;
+            if (negative && bits < 64) {
+                v |= ~static_cast<uint64_t>(0) << bits;
+            }
+            header = (v << 1) ^ (negative ? ~static_cast<uint64_t>(0) : 0);
+        }
+        if (bits > 64 || header >> 63 != 0) {
+            bytes = byte_length(a);
+            header = (static_cast<uint64_t>(bytes) << 1) | 1;
+        } else {
+            header <<= 1;
+        }
+
+        for (; header >= 0x80; header >>= 7) {
+            out.push_back(static_cast<unsigned char>(header | 0x80));
+        }
+        out.push_back(static_cast<unsigned char>(header));
+        if (bytes != 0) {
+            out.resize(out.size() + bytes);
+            to_bytes(a, out.data() + out.size() - bytes, bytes);
+        }
+    }
+}
+
+size_t decode_varints(unsigned char const* data, size_t size, big_integer* values, size_t count) {
+    size_t pos = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t header = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            if (pos == size) {
+                throw std::runtime_error("Truncated varint");
+            }
+            if (shift > 63 || (shift == 63 && data[pos] > 1)) {
+                throw std::runtime_error("Varint header does not fit in 64 bits");
+            }
+            header |= static_cast<uint64_t>(data[pos] & 0x7f) << shift;
+            if (data[pos++] < 0x80) {
+                break;
+            }
+        }
+
+        if (header % 2 == 0) {
+            // small values do not leave the inline storage
+            uint64_t zigzag = header >> 1;
+            values[i].assign_int64(static_cast<int64_t>((zigzag >> 1) ^ (0 - (zigzag & 1))));
+        } else {
+            uint64_t bytes = header >> 1;
+            if (bytes > size - pos) {
+                throw std::runtime_error("Truncated varint");
+            }
+            values[i] = from_bytes(data + pos, static_cast<size_t>(bytes));
+            pos += static_cast<size_t>(bytes);
+        }
+    }
+    return pos;
+}
+
+unsigned char big_integer::get_byte(size_t i) const {
+    return static_cast<unsigned char>(get(i / sizeof(int_t)) >> (8 * (i % sizeof(int_t))));
+}
+
 big_integer::int_t big_integer::get(size_t i) const {
     return size() > i ? values[i] : (is_negative() ? INT_T_MAX : 0);
 }
@@ -508,10 +1260,47 @@ void big_integer::shrink_to_fit() {
     }
 }
 
-void big_integer::swap(big_integer &other) {
-    std::swap(values, other.values);
+void big_integer::swap(big_integer &other) noexcept {
+    values.swap(other.values);
 }
 
 big_integer::int_t big_integer::get_rest() const {
     return is_negative() ? INT_T_MAX : 0;
 }
+
+// absolute value without leading zero limbs
+scratch_vector<big_integer::int_t> big_integer::magnitude() const {
+    scratch_vector<int_t> res(size());
+    bool neg = is_negative();
+    int_t carry = neg;
+    for (size_t i = 0; i < size(); i++) {
+        res[i] = (neg ? ~values[i] : values[i]) + carry;
+        carry = carry && res[i] == 0;
+    }
+
+    while (!res.empty() && res.back() == 0) {
+        res.pop_back();
+    }
+    return res;
+}
+
+// at most two 32-bit or one 64-bit limbs, fits in the small object state of storage_t without allocation
+big_integer& big_integer::assign_int64(int64_t a) {
+    storage_t res(sizeof(int64_t) / sizeof(int_t), 0);
+    for (size_t i = 0; i < res.size(); i++) {
+        res[i] = static_cast<int_t>(static_cast<uint64_t>(a) >> (i * INT_T_BITS));
+    }
+    values = std::move(res);
+    shrink_to_fit();
+    return *this;
+}
+
+big_integer& big_integer::assign_magnitude(scratch_vector<int_t> const& mag, bool negative) {
+    values.assign(mag.size() + 1, 0);
+    for (size_t i = 0; i < mag.size(); i++) {
+        values[i] = mag[i];
+    }
+
+    shrink_to_fit();
+    return negative ? negate() : *this;
+}
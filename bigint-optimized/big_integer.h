@@ -5,30 +5,93 @@
 #include <stdint.h>
 #include <utility>
 #include <vector>
+#include <string>
 #include <limits>
+#ifdef BIG_INTEGER_MMAP_STORAGE
+#ifdef BIG_INTEGER_THREAD_SAFE
+#error "mmap storage does not support sharing between threads"
+#endif
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+#error "mmap storage does not support memory resources"
+#endif
+#include <mmap_storage.h>
+#else
 #include <optimized_storage.h>
+#endif
+
+// vector for limbs of intermediate results, with BIG_INTEGER_MEMORY_RESOURCE they come from default_resource()
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+template <typename T>
+using scratch_vector = std::vector<T, resource_allocator<T>>;
+#else
+template <typename T>
+using scratch_vector = std::vector<T>;
+#endif
+
+struct big_divisor;
 
 struct big_integer {
+#ifdef BIG_INTEGER_64BIT_LIMBS
+    using int_t = uint64_t;
+    using double_int_t = __uint128_t;
+#else
     using int_t = uint32_t;
     using double_int_t = uint64_t;
-    using quad_int_t = __uint128_t;
+#endif
     static const int INT_T_BITS = std::numeric_limits<int_t>::digits;
     static const int_t INT_T_MAX = std::numeric_limits<int_t>::max();
-    using storage_t = optimized_storage<int_t>;
+#ifdef BIG_INTEGER_INLINE_LIMBS
+    static const size_t INLINE_LIMBS = BIG_INTEGER_INLINE_LIMBS;
+#else
+    // the limbs that fit in a storage of three words
+    static const size_t INLINE_LIMBS = 2 * sizeof(void*) / sizeof(int_t);
+#endif
+    // int64_t values, see assign_int64, are built without a heap buffer
+    static_assert(INLINE_LIMBS * sizeof(int_t) >= sizeof(int64_t), "inline limbs should hold an int64_t");
+#if defined(BIG_INTEGER_MMAP_STORAGE)
+    using storage_t = mmap_storage<int_t, INLINE_LIMBS>;
+#elif defined(BIG_INTEGER_THREAD_SAFE)
+    // copies sharing a buffer may be used by different threads
+    using storage_t = optimized_storage<int_t, INLINE_LIMBS, atomic_buffer>;
+#else
+    using storage_t = optimized_storage<int_t, INLINE_LIMBS>;
+#endif
+
+    // order of words in a byte array and of bytes in a word, see to_bytes
+    enum class endian { little, big };
 
     big_integer();
     big_integer(big_integer const& other);
+    // other is left equal to zero
+    big_integer(big_integer&& other) noexcept;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // copy of other whose blocks come from resource for its whole life, nullptr for operator new;
+    // other constructors take default_resource() at the time of construction
+    big_integer(big_integer const& other, memory_resource* resource);
+#endif
     big_integer(int a);
     explicit big_integer(std::string const& str);
+    // base is 10 or a power of two up to 32, digits above 9 are letters of either case
+    explicit big_integer(std::string const& str, int base);
     ~big_integer() = default;
 
     big_integer& operator=(big_integer const& other);
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // copies the value if other has another resource
+    big_integer& operator=(big_integer&& other);
+#else
+    big_integer& operator=(big_integer&& other) noexcept;
+#endif
 
     big_integer& operator+=(big_integer const& rhs);
     big_integer& operator-=(big_integer const& rhs);
     big_integer& operator*=(big_integer const& rhs);
     big_integer& operator/=(big_integer const& rhs);
     big_integer& operator%=(big_integer const& rhs);
+    big_integer& operator/=(big_divisor const& rhs);
+    big_integer& operator%=(big_divisor const& rhs);
+    big_integer& square();
+    big_integer& divexact(big_integer const& rhs);
 
     big_integer& operator&=(big_integer const& rhs);
     big_integer& operator|=(big_integer const& rhs);
@@ -48,34 +111,87 @@ struct big_integer {
     big_integer operator--(int);
 
     friend std::ostream& operator<<(std::ostream& s, big_integer a);
+    friend std::istream& operator>>(std::istream& s, big_integer& a);
+    friend size_t byte_length(big_integer const& a, size_t word_size);
+    friend bool to_bytes(big_integer const& a, void* out, size_t size, size_t word_size,
+                         endian word_order, endian byte_order);
+    friend big_integer from_bytes(void const* data, size_t size, size_t word_size,
+                                  endian word_order, endian byte_order);
+    friend void encode_varints(big_integer const* values, size_t count, std::vector<unsigned char>& out);
+    friend size_t decode_varints(unsigned char const* data, size_t size, big_integer* values, size_t count);
+    friend std::string to_string(big_integer const& a);
+    friend std::string to_string(big_integer const& a, int base);
+    friend big_integer operator+(big_integer&& a, big_integer&& b);
+    friend big_integer operator*(big_integer&& a, big_integer&& b);
+    friend big_integer operator&(big_integer&& a, big_integer&& b);
+    friend big_integer operator|(big_integer&& a, big_integer&& b);
+    friend big_integer operator^(big_integer&& a, big_integer&& b);
 
     int compare_to(big_integer const&) const;
     big_integer& negate();
-    void swap(big_integer&);
+    void swap(big_integer&) noexcept;
     big_integer& negate_bits();
     bool is_negative() const;
     std::tuple<big_integer, big_integer> divide(big_integer);
+    std::tuple<big_integer, big_integer> divide(big_divisor const&) const;
+#ifdef BIG_INTEGER_MMAP_STORAGE
+    // limbs in the native layout, load maps the file copy-on-write instead of reading it
+    void save(std::string const& path) const;
+    static big_integer load(std::string const& path);
+#endif
 
 private:
+    friend struct big_divisor;
+    // reaches the internal division paths with short operands in tests
+    friend struct big_integer_test_access;
+
     big_integer(int_t);
     int compare_to(big_integer const&, size_t offset) const;
     big_integer& sum_with(big_integer const&, size_t my_offset, int_t carry);
     big_integer& sum_with(big_integer const&, int_t carry);
-    big_integer& diff_with(big_integer const&, size_t my_offset);
     int_t get(size_t) const;
+    unsigned char get_byte(size_t) const;
     int_t get_rest() const;
     size_t size() const;
     big_integer& push_zero();
     big_integer& bit_operation(big_integer const&, int_t (int_t, int_t));
     void shrink_to_fit();
+    scratch_vector<int_t> magnitude() const;
+    big_integer& assign_magnitude(scratch_vector<int_t> const&, bool negative);
+    big_integer& assign_int64(int64_t);
     std::tuple<big_integer, int_t> divide(int_t rhs);
-    std::tuple<big_integer, big_integer> long_divide(big_integer const& rhs);
+    std::tuple<big_integer, big_integer> long_divide(big_integer const& rhs) const;
+    size_t bit_length() const;
+    big_integer& shift_left(size_t);
+    big_integer& shift_right(size_t);
+    static big_integer reciprocal(big_integer const& d, size_t k, size_t threshold);
+    std::tuple<big_integer, big_integer> reciprocal_divide(big_integer const& rhs, big_integer const& x,
+                                                           size_t k) const;
+    std::tuple<big_integer, big_integer> newton_divide(big_integer const& rhs, size_t threshold) const;
     std::tuple<big_integer, big_integer> divide_positive(big_integer const&);
-    friend int_t trial(big_integer const&, big_integer const&, size_t);
+    static big_integer const& decimal_power(size_t k);
+    static big_divisor const& decimal_divisor(size_t k);
+    static void to_decimal(big_integer const& a, size_t chunks, char* last);
+    static big_integer from_decimal(int_t const* first, int_t const* last);
 
     storage_t values;
 };
 
+// divisor with precomputed normalization and reciprocal for repeated division by the same value
+struct big_divisor {
+    explicit big_divisor(big_integer const& d);
+
+    big_integer const& value() const;
+
+private:
+    friend struct big_integer;
+
+    big_integer d;
+    unsigned shift;
+    scratch_vector<big_integer::int_t> normalized;
+    scratch_vector<big_integer::int_t> reciprocal;
+};
+
 bool operator==(big_integer const& a, big_integer const& b);
 bool operator!=(big_integer const& a, big_integer const& b);
 bool operator<(big_integer const& a, big_integer const& b);
@@ -84,16 +200,59 @@ bool operator<=(big_integer const& a, big_integer const& b);
 bool operator>=(big_integer const& a, big_integer const& b);
 
 std::string to_string(big_integer const& a);
+// sign and magnitude in base 10 or a power of two up to 32, lowercase digits
+std::string to_string(big_integer const& a, int base);
+
+// bytes in the shortest two's complement of a, rounded up to whole words of word_size bytes
+size_t byte_length(big_integer const& a, size_t word_size = 1);
+// writes a into out[0..size) as two's complement sign extended to size bytes: size / word_size words
+// in word_order with bytes of every word in byte_order, returns false and writes nothing if a does not fit
+bool to_bytes(big_integer const& a, void* out, size_t size, size_t word_size = 1,
+              big_integer::endian word_order = big_integer::endian::little,
+              big_integer::endian byte_order = big_integer::endian::little);
+// byte_length(a, word_size) bytes of a in the layout of to_bytes
+std::vector<unsigned char> to_bytes(big_integer const& a, size_t word_size = 1,
+                                    big_integer::endian word_order = big_integer::endian::little,
+                                    big_integer::endian byte_order = big_integer::endian::little);
+// two's complement value of data[0..size) in the layout of to_bytes
+big_integer from_bytes(void const* data, size_t size, size_t word_size = 1,
+                       big_integer::endian word_order = big_integer::endian::little,
+                       big_integer::endian byte_order = big_integer::endian::little);
+
+// appends values[0..count) to out, every value starts with an LEB128 header: its zig-zag code times two
+// for values in [-2^62, 2^62), otherwise its byte_length times two plus one followed by to_bytes of the value
+void encode_varints(big_integer const* values, size_t count, std::vector<unsigned char>& out);
+// reads count values of encode_varints from data[0..size) into values, returns the number of bytes read
+size_t decode_varints(unsigned char const* data, size_t size, big_integer* values, size_t count);
 
-big_integer operator+(big_integer a, big_integer const& b);
+// an rvalue operand gives its buffer to the result, for two of them the one with the larger buffer does
+big_integer operator+(big_integer const& a, big_integer const& b);
+big_integer operator+(big_integer&& a, big_integer const& b);
+big_integer operator+(big_integer const& a, big_integer&& b);
+big_integer operator+(big_integer&& a, big_integer&& b);
 big_integer operator-(big_integer a, big_integer const& b);
-big_integer operator*(big_integer a, big_integer const& b);
+big_integer operator-(big_integer const& a, big_integer&& b);
+big_integer operator*(big_integer const& a, big_integer const& b);
+big_integer operator*(big_integer&& a, big_integer const& b);
+big_integer operator*(big_integer const& a, big_integer&& b);
+big_integer operator*(big_integer&& a, big_integer&& b);
 big_integer operator/(big_integer a, big_integer const& b);
 big_integer operator%(big_integer a, big_integer const& b);
+big_integer operator/(big_integer a, big_divisor const& b);
+big_integer operator%(big_integer a, big_divisor const& b);
 
-big_integer operator&(big_integer a, big_integer const& b);
-big_integer operator|(big_integer a, big_integer const& b);
-big_integer operator^(big_integer a, big_integer const& b);
+big_integer operator&(big_integer const& a, big_integer const& b);
+big_integer operator&(big_integer&& a, big_integer const& b);
+big_integer operator&(big_integer const& a, big_integer&& b);
+big_integer operator&(big_integer&& a, big_integer&& b);
+big_integer operator|(big_integer const& a, big_integer const& b);
+big_integer operator|(big_integer&& a, big_integer const& b);
+big_integer operator|(big_integer const& a, big_integer&& b);
+big_integer operator|(big_integer&& a, big_integer&& b);
+big_integer operator^(big_integer const& a, big_integer const& b);
+big_integer operator^(big_integer&& a, big_integer const& b);
+big_integer operator^(big_integer const& a, big_integer&& b);
+big_integer operator^(big_integer&& a, big_integer&& b);
 
 big_integer operator<<(big_integer a, int b);
 big_integer operator>>(big_integer a, int b);
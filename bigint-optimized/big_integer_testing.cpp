@@ -1,13 +1,20 @@
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
 #include <random>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <utility>
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
 #include "big_integer_gmp.h"
+#include "limbs.h"
+#ifdef BIG_INTEGER_BUFFER_POOL
+#include "buffer_pool.h"
+#endif
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -76,6 +83,44 @@ TEST(correctness, assignment_return_value) {
   EXPECT_TRUE(b == 7);
 }
 
+TEST(correctness, move_ctor) {
+  big_integer a = big_integer(1) << 200;
+  big_integer b = std::move(a);
+  big_integer c = 5;
+  c = std::move(b);
+
+  EXPECT_EQ(big_integer(1) << 200, c);
+  EXPECT_EQ(0, a);
+  EXPECT_EQ(a + 1, 1);
+}
+
+TEST(correctness, rvalue_operators) {
+  big_integer a = (big_integer(1) << 300) - 7;
+  big_integer b = -(big_integer(1) << 40);
+
+  EXPECT_EQ(a + b, big_integer(a) + big_integer(b));
+  EXPECT_EQ(a + b, a + big_integer(b));
+  EXPECT_EQ(a - b, a - big_integer(b));
+  EXPECT_EQ(b - a, b - big_integer(a));
+  EXPECT_EQ(a * b, big_integer(b) * big_integer(a));
+  EXPECT_EQ(a & b, b & big_integer(a));
+  EXPECT_EQ(a | b, big_integer(b) | big_integer(a));
+  EXPECT_EQ(a ^ b, big_integer(a) ^ b);
+  EXPECT_EQ(a * a, big_integer(a) * big_integer(a));
+}
+
+#ifndef BIG_INTEGER_INLINE_LIMBS
+TEST(correctness, storage_layout) {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+  // and the resource of the value
+  EXPECT_EQ(4 * sizeof(void*), sizeof(big_integer));
+#else
+  EXPECT_EQ(3 * sizeof(void*), sizeof(big_integer));
+#endif
+  EXPECT_EQ(2 * sizeof(void*) / sizeof(big_integer::int_t), big_integer::INLINE_LIMBS);
+}
+#endif
+
 TEST(correctness, comparisons) {
   big_integer a = 100;
   big_integer b = 100;
@@ -185,6 +230,15 @@ TEST(correctness, mul_return_value) {
   EXPECT_EQ(20, a);
 }
 
+TEST(correctness, square) {
+  big_integer a = -12345;
+  big_integer b = a;
+
+  EXPECT_EQ(a.square(), 152399025);
+  EXPECT_EQ(b *= b, 152399025);
+  EXPECT_EQ(big_integer(0).square(), 0);
+}
+
 TEST(correctness, div_) {
   big_integer a = 20;
   big_integer b = 5;
@@ -451,6 +505,14 @@ TEST(correctness, add_long_signed2) {
   EXPECT_EQ(c, a + b);
 }
 
+TEST(correctness, add_long_to_short) {
+  big_integer a("123456789012345678901234567890123456789");
+  big_integer c("123456789012345678901234567890123456794");
+
+  EXPECT_EQ(c, big_integer(5) + a);
+  EXPECT_EQ(c, big_integer(0) + a + 5);
+}
+
 TEST(correctness, add_long_pow2) {
   big_integer a("18446744073709551616");
   big_integer b("-18446744073709551616");
@@ -577,6 +639,323 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, string_conv_radix) {
+  EXPECT_EQ("ff", to_string(big_integer(255), 16));
+  EXPECT_EQ("-11111111", to_string(big_integer(-255), 2));
+  EXPECT_EQ("-377", to_string(big_integer(-255), 8));
+  EXPECT_EQ("0", to_string(big_integer(0), 32));
+  EXPECT_EQ("1" + std::string(25, '0'), to_string(big_integer(1) << 100, 16));
+  EXPECT_EQ(big_integer(1) << 100, big_integer("1" + std::string(20, '0'), 32));
+  EXPECT_EQ(big_integer(-255), big_integer("-Ff", 16));
+  EXPECT_EQ(big_integer(255), big_integer("+0000000000000000000000000377", 8));
+  EXPECT_EQ(big_integer(100), big_integer("100", 10));
+  EXPECT_THROW(big_integer("12", 2), std::runtime_error);
+  EXPECT_THROW(big_integer("12", 12), std::runtime_error);
+  EXPECT_THROW(to_string(big_integer(12), 3), std::runtime_error);
+
+  std::stringstream ss;
+  ss << std::hex << big_integer(-255) << ' ' << std::showbase << std::uppercase << big_integer(-255) << ' '
+     << std::oct << big_integer(8) << ' ' << std::dec << big_integer(8);
+  EXPECT_EQ("-ff -0XFF 010 8", ss.str());
+}
+
+TEST(correctness, string_conv_radix_randomized) {
+  std::default_random_engine rng(5);
+  for (int base : {2, 4, 8, 16, 32}) {
+    for (size_t length : {1, 7, 31, 64, 1000}) {
+      std::string digits = "1";
+      big_integer expected = 1;
+      for (size_t i = 1; i < length; i++) {
+        int digit = static_cast<int>(rng() % base);
+        digits.push_back("0123456789abcdefghijklmnopqrstuv"[digit]);
+        expected = expected * base + digit;
+      }
+      EXPECT_EQ(expected, big_integer(digits, base));
+      EXPECT_EQ(digits, to_string(expected, base));
+      EXPECT_EQ("-" + digits, to_string(-expected, base));
+      EXPECT_EQ(-expected, big_integer("-" + digits, base));
+    }
+  }
+}
+
+TEST(correctness, stream_input) {
+  std::istringstream in("  -123456789012345678901234567890 +42\n ff 17x -");
+  big_integer a, b, c, d;
+  in >> a >> b >> std::hex >> c >> std::oct >> d;
+  EXPECT_TRUE(in.good());
+  EXPECT_EQ(big_integer("-123456789012345678901234567890"), a);
+  EXPECT_EQ(42, b);
+  EXPECT_EQ(255, c);
+  EXPECT_EQ(15, d);
+  EXPECT_EQ('x', in.get());
+  EXPECT_FALSE(in >> a);
+  EXPECT_EQ(0, a);
+
+  std::istringstream prefixed("0x1F -0XfF 0x 017 0x10 10");
+  prefixed >> std::hex >> a >> b >> c >> std::oct >> d;
+  EXPECT_EQ(31, a);
+  EXPECT_EQ(-255, b);
+  EXPECT_EQ(0, c);
+  EXPECT_EQ(15, d);
+  prefixed.unsetf(std::ios_base::basefield);
+  prefixed >> a >> b;
+  EXPECT_EQ(16, a);
+  EXPECT_EQ(10, b);
+
+  std::default_random_engine rng(9);
+  for (size_t size : {10, 1000, 100000}) {
+    big_integer_gmp g;
+    g.random(size, rng);
+    big_integer x(to_string(g));
+    for (auto base : {std::ios_base::dec, std::ios_base::hex, std::ios_base::oct}) {
+      std::stringstream ss;
+      ss.setf(base, std::ios_base::basefield);
+      ss << x << ' ' << std::showbase << x;
+      big_integer y, z;
+      ss >> y >> z;
+      EXPECT_EQ(x, y);
+      EXPECT_EQ(x, z);
+      EXPECT_TRUE(ss.eof());
+      EXPECT_FALSE(ss.fail());
+    }
+  }
+}
+
+TEST(correctness, bytes) {
+  using bytes = std::vector<unsigned char>;
+  using endian = big_integer::endian;
+  EXPECT_EQ(bytes({0x00}), to_bytes(0));
+  EXPECT_EQ(bytes({0xff}), to_bytes(-1));
+  EXPECT_EQ(bytes({0x80, 0x00}), to_bytes(128));
+  EXPECT_EQ(bytes({0x80}), to_bytes(-128));
+  EXPECT_EQ(bytes({0x00, 0x00, 0x01, 0x02}), to_bytes(0x0102, 4, endian::little, endian::big));
+  EXPECT_EQ(bytes({0x05, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04}),
+            to_bytes(big_integer("21542142465", 10), 4, endian::big, endian::little));
+
+  unsigned char buf[6];
+  EXPECT_FALSE(to_bytes(big_integer(1) << 47, buf, 6));
+  EXPECT_TRUE(to_bytes(-(big_integer(1) << 47), buf, 6, 2, endian::big, endian::big));
+  EXPECT_EQ(bytes({0x80, 0x00, 0x00, 0x00, 0x00, 0x00}), bytes(buf, buf + 6));
+  EXPECT_EQ(-(big_integer(1) << 47), from_bytes(buf, 6, 2, endian::big, endian::big));
+  EXPECT_EQ(0, from_bytes(buf, 0));
+  EXPECT_THROW(from_bytes(buf, 5, 2), std::runtime_error);
+}
+
+TEST(correctness, bytes_randomized) {
+  using endian = big_integer::endian;
+  std::default_random_engine rng(10);
+  for (size_t size : {1, 31, 32, 33, 64, 1000, 100000}) {
+    big_integer_gmp g;
+    g.random(size, rng);
+    big_integer x(to_string(g));
+    for (size_t word_size : {1, 2, 3, 8}) {
+      for (endian word_order : {endian::little, endian::big}) {
+        for (endian byte_order : {endian::little, endian::big}) {
+          std::vector<unsigned char> b = to_bytes(x, word_size, word_order, byte_order);
+          EXPECT_EQ(x, from_bytes(b.data(), b.size(), word_size, word_order, byte_order));
+          EXPECT_EQ(byte_length(x, word_size), b.size());
+          b.resize(b.size() + 2 * word_size);
+          EXPECT_TRUE(to_bytes(x, b.data(), b.size(), word_size, word_order, byte_order));
+          EXPECT_EQ(x, from_bytes(b.data(), b.size(), word_size, word_order, byte_order));
+        }
+      }
+    }
+  }
+}
+
+TEST(correctness, varints) {
+  big_integer p62 = big_integer(1) << 62;
+  std::vector<big_integer> values = {0, -1, 31, -32, 32, p62 - 1, -p62, p62, -p62 - 1,
+                                     big_integer(1) << 1000, -(big_integer(3) << 5000)};
+  std::default_random_engine rng(11);
+  for (size_t i = 0; i < 100; i++) {
+    values.push_back(static_cast<int>(rng()) >> (rng() % 31));
+  }
+
+  std::vector<unsigned char> buf = {0xab};
+  encode_varints(values.data(), values.size(), buf);
+  std::vector<big_integer> decoded(values.size(), big_integer(1) << 100);
+  EXPECT_EQ(buf.size() - 1, decode_varints(buf.data() + 1, buf.size() - 1, decoded.data(), decoded.size()));
+  EXPECT_EQ(values, decoded);
+
+  std::vector<unsigned char> small;
+  encode_varints(values.data(), 5, small);
+  EXPECT_EQ(6u, small.size());
+  EXPECT_THROW(decode_varints(buf.data() + 1, buf.size() - 2, decoded.data(), decoded.size()), std::runtime_error);
+}
+
+#ifdef BIG_INTEGER_MMAP_STORAGE
+TEST(correctness, mmap_storage) {
+  // 2^22 limbs are past the mmap threshold, every shift grows the mapping
+  big_integer a = (big_integer(1) << (1 << 27)) - 1;
+  big_integer b = a;
+  for (int i = 0; i < 4; i++) {
+    a <<= 1 << 20;
+    a += 1;
+  }
+  EXPECT_EQ(b, a >> (1 << 22));
+
+  std::string path = "big_integer_mmap_storage.tmp";
+  a.save(path);
+  big_integer c = big_integer::load(path);
+  EXPECT_EQ(a, c);
+  c += 2;
+  EXPECT_EQ(a + 2, c);
+  EXPECT_EQ(a, big_integer::load(path));
+
+  big_integer(-5).save(path);
+  EXPECT_EQ(-5, big_integer::load(path));
+  std::remove(path.c_str());
+  EXPECT_THROW(big_integer::load(path), std::runtime_error);
+}
+#endif
+
+#ifdef BIG_INTEGER_THREAD_SAFE
+TEST(correctness, shared_between_threads) {
+  big_integer const shared = (big_integer(3) << 5000) + 1;
+  std::vector<big_integer> results(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); i++) {
+    threads.emplace_back([&shared, &results, i]() {
+      for (int j = 0; j < 1000; j++) {
+        big_integer copy = shared;
+        big_integer other = copy;
+        copy += static_cast<int>(i);
+        results[i] = other - shared + copy;
+      }
+    });
+  }
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  for (size_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(shared + static_cast<int>(i), results[i]);
+  }
+}
+#endif
+
+#ifdef BIG_INTEGER_BUFFER_POOL
+TEST(correctness, buffer_pool) {
+  // blocks freed by a finished thread are reused by the next one
+  for (int t = 0; t < 4; t++) {
+    std::thread([t]() {
+      std::vector<big_integer> values;
+      for (int i = 0; i < 500; i++) {
+        values.push_back((big_integer(i + t) << (i * 7)) + i);
+      }
+      for (int i = 0; i < 500; i += 3) {
+        EXPECT_EQ(big_integer(i + t), (values[i] - i) >> (i * 7));
+      }
+    }).join();
+  }
+}
+
+TEST(correctness, buffer_pool_allocating_threads) {
+  // this thread fills the depot, threads that only allocate take a batch from it and give the rest back at exit
+  for (int t = 0; t < 4; t++) {
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < 2 * buffer_pool::CACHE_SIZE; i++) {
+      blocks.push_back(buffer_pool::allocate(64));
+    }
+    for (void* block : blocks) {
+      buffer_pool::deallocate(block, 64);
+    }
+
+    void* taken = nullptr;
+    std::thread([&taken]() {
+      taken = buffer_pool::allocate(64);
+    }).join();
+    buffer_pool::deallocate(taken, 64);
+  }
+}
+#endif
+
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+namespace {
+struct counting_resource : monotonic_resource {
+  void* allocate(size_t bytes) override {
+    allocated++;
+    return monotonic_resource::allocate(bytes);
+  }
+
+  size_t allocated = 0;
+};
+}
+
+TEST(correctness, memory_resource) {
+  big_integer outside = big_integer(1) << 1000;
+  big_integer expected = big_integer(3) << 2000;
+  for (int i = 0; i < 10; i++) {
+    expected = expected * expected + outside;
+  }
+  big_integer kept;
+  big_integer grown = 1;
+  big_integer assigned = 1;
+  {
+    counting_resource arena;
+    scoped_resource scope(&arena);
+    big_integer a = big_integer(3) << 2000;
+    for (int i = 0; i < 10; i++) {
+      a = a * a + outside;
+    }
+    EXPECT_NE(0u, arena.allocated);
+    kept = big_integer(a, nullptr);
+    outside += 1;
+    EXPECT_EQ(a % outside, kept % outside);
+
+    // values made before the scope keep growing on the heap and are read after the arena is gone
+    grown <<= 5000;
+    grown *= grown;
+    assigned = a;
+  }
+  EXPECT_EQ(big_integer(1) << 1000, outside - 1);
+  EXPECT_EQ(expected, kept);
+  EXPECT_EQ(big_integer(1) << 10000, grown);
+  EXPECT_EQ("1" + std::string(10000, '0'), to_string(grown, 2));
+  EXPECT_EQ(expected, assigned);
+
+  // the cache of decimal powers is made on the heap and outlives the arena
+  std::string digits(5000, '7');
+  {
+    counting_resource parse_arena;
+    scoped_resource scope(&parse_arena);
+    EXPECT_EQ(digits, to_string(big_integer(digits)));
+  }
+  EXPECT_EQ(digits, to_string(big_integer(digits)));
+
+  counting_resource arena;
+  big_integer in_arena(outside, &arena);
+  EXPECT_EQ(1u, arena.allocated);
+  // later blocks of the value come from its resource too
+  in_arena <<= 5000;
+  EXPECT_EQ(2u, arena.allocated);
+  in_arena = in_arena * in_arena;
+  EXPECT_EQ(3u, arena.allocated);
+  EXPECT_EQ((outside * outside) << 10000, in_arena);
+  // a copy outside of the scope of the arena takes its block from the heap
+  big_integer copy = in_arena;
+  copy += 1;
+  EXPECT_EQ(3u, arena.allocated);
+  EXPECT_EQ(in_arena + 1, copy);
+}
+#endif
+
+TEST(correctness, string_conv_chunks) {
+  std::string nines = "9", power = "10";
+  for (size_t i = 0; i < 45; i++) {
+    EXPECT_EQ(power, to_string(big_integer(nines) + 1));
+    EXPECT_EQ("-" + nines, to_string(-big_integer(power) + 1));
+    nines.push_back('9');
+    power.push_back('0');
+  }
+  EXPECT_EQ("123", to_string(big_integer("+000000000000000000000000123")));
+  EXPECT_THROW(big_integer("1234567890123x"), std::runtime_error);
+
+  std::stringstream ss;
+  ss << big_integer("-100000000000000000000000000001");
+  EXPECT_EQ("-100000000000000000000000000001", ss.str());
+}
+
 namespace {
 size_t const number_of_iterations = 10;
 size_t const max_size = 2048;
@@ -652,6 +1031,27 @@ T merge_all(std::vector<T> v) {
 }
 }
 
+TEST(correctness, divexact_randomized) {
+  for (unsigned itn = 0; itn != number_of_iterations; ++itn) {
+    std::vector<int> multipliers;
+
+    for (size_t i = 0; i != number_of_multipliers; ++i)
+      multipliers.push_back(myrand());
+
+    big_integer accumulator = 1;
+
+    for (size_t i = 0; i != number_of_multipliers; ++i)
+      accumulator *= multipliers[i];
+
+    std::shuffle(multipliers.begin(), multipliers.end(), std::mt19937(std::random_device()()));
+
+    for (size_t i = 1; i != number_of_multipliers; ++i)
+      accumulator.divexact(multipliers[i]);
+
+    EXPECT_TRUE(accumulator == multipliers[0]);
+  }
+}
+
 TEST(correctness, mul_merge_randomized) {
   for (unsigned itn = 0; itn != number_of_iterations; ++itn) {
     std::vector<big_integer> x;
@@ -744,6 +1144,135 @@ TEST(correctness_random, mul) {
   }
 }
 
+TEST(correctness_random, mul_karatsuba) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b;
+    a.random(max_size * 16, rng);
+    b.random(max_size * (itn + 1), rng);
+    big_integer_gmp c = a * b;
+    big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+    EXPECT_EQ(to_string(c), to_string(R));
+  }
+}
+
+TEST(correctness_random, mul_toom) {
+  std::default_random_engine rng(42);
+  for (size_t size : {4000, 6000, 9000, 16000, 30000}) {
+    big_integer_gmp a, b;
+    a.random(size, rng);
+    b.random(size, rng);
+    big_integer_gmp c = a * b;
+    big_integer R = big_integer(to_string(a)) * big_integer(to_string(b));
+    EXPECT_EQ(to_string(c), to_string(R));
+  }
+}
+
+namespace {
+template<typename T>
+T rand_bits(size_t bits, std::default_random_engine& rng) {
+  // chunks are merged pairwise, so that huge numbers are built in O(n log n)
+  std::vector<std::pair<T, int>> parts;
+  for (size_t i = 0; i < bits; i += 3000) {
+    T chunk = 0;
+    for (size_t j = 0; j < 3000; j += 30) {
+      chunk <<= 30;
+      chunk += static_cast<int>(rng() % (1 << 30));
+    }
+    parts.emplace_back(chunk, 3000);
+  }
+  while (parts.size() > 1) {
+    std::vector<std::pair<T, int>> merged;
+    for (size_t i = 0; i + 1 < parts.size(); i += 2) {
+      merged.emplace_back((parts[i].first << parts[i + 1].second) + parts[i + 1].first,
+                          parts[i].second + parts[i + 1].second);
+    }
+    if (parts.size() % 2 == 1) {
+      merged.push_back(parts.back());
+    }
+    parts.swap(merged);
+  }
+  return parts.empty() ? T(0) : parts[0].first;
+}
+}
+
+TEST(correctness_random, mul_unbalanced) {
+  std::default_random_engine rng(42);
+  for (size_t size : {40, 1100, 2000, 5000, 12000}) {
+    big_integer_gmp a, b;
+    a.random(60000, rng);
+    b.random(size, rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+    EXPECT_EQ(to_string(b * a), to_string(B * A));
+  }
+}
+
+TEST(correctness_random, mul_ntt) {
+  std::default_random_engine rng(42);
+  for (size_t size : {300000, 600000}) {
+    std::default_random_engine rng_copy = rng;
+    big_integer_gmp a = rand_bits<big_integer_gmp>(size, rng_copy);
+    big_integer_gmp b = rand_bits<big_integer_gmp>(size, rng_copy);
+    big_integer A = rand_bits<big_integer>(size, rng);
+    big_integer B = rand_bits<big_integer>(size, rng);
+    big_integer_gmp c = a * b;
+    big_integer R = A * B;
+
+    for (int mod : {2147483647, 1000000007, 998244353, 65536}) {
+      EXPECT_EQ(to_string(c % mod), to_string(R % mod));
+    }
+
+    int half = static_cast<int>(size / 2);
+    big_integer A_low = A & ((big_integer(1) << half) - 1);
+    big_integer B_low = B & ((big_integer(1) << half) - 1);
+    big_integer A_high = A >> half;
+    big_integer B_high = B >> half;
+    EXPECT_EQ(R, ((A_high * B_high) << (2 * half))
+               + ((A_high * B_low + A_low * B_high) << half)
+               + A_low * B_low);
+  }
+}
+
+// exactly limbs limbs of big_integer, the top bit set
+template <typename T>
+T rand_limbs(size_t limbs, std::default_random_engine& rng) {
+  int bits = static_cast<int>(limbs) * big_integer::INT_T_BITS;
+  int extra = (bits + 2999) / 3000 * 3000 - bits;
+  return (rand_bits<T>(bits, rng) >> (extra + 1)) + (T(1) << (bits - 1));
+}
+
+TEST(correctness_random, mul_ntt_threshold) {
+  // Toom-4 just below the threshold, NTT from it on, products compared in full
+  std::default_random_engine rng(42);
+  size_t t = limbs::NTT_THRESHOLD;
+  std::vector<std::pair<size_t, size_t>> sizes = {
+      {t - 1, t - 1}, {t, t}, {t + 1, t + 1}, {3 * t, t - 1}, {3 * t, t}};
+  for (auto const& size : sizes) {
+    std::default_random_engine rng_copy = rng;
+    big_integer_gmp a = rand_limbs<big_integer_gmp>(size.first, rng_copy);
+    big_integer_gmp b = rand_limbs<big_integer_gmp>(size.second, rng_copy);
+    big_integer A = rand_limbs<big_integer>(size.first, rng);
+    big_integer B = rand_limbs<big_integer>(size.second, rng);
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+  }
+}
+
+TEST(correctness_random, square) {
+  std::default_random_engine rng(42);
+  for (size_t size : {100, 2000, 5000, 20000, 40000}) {
+    big_integer_gmp a;
+    a.random(size, rng);
+    big_integer A = big_integer(to_string(a));
+    EXPECT_EQ(to_string(a * a), to_string(A * A));
+    EXPECT_EQ(to_string(a * a), to_string(A.square()));
+  }
+
+  big_integer A = rand_bits<big_integer>(400000, rng);
+  EXPECT_EQ(A * (A + 1) - A, A * A);
+}
+
 TEST(correctness_random, div) {
   std::default_random_engine rng(322);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -776,6 +1305,137 @@ TEST(correctness_random, mod) {
   }
 }
 
+TEST(correctness_random, div_short) {
+  std::default_random_engine rng(322);
+  for (int d : {1, 2, 3, 10, 65536, 1000000007, std::numeric_limits<int>::max()}) {
+    big_integer_gmp a;
+    a.random(max_size, rng);
+    big_integer A = big_integer(to_string(a));
+    EXPECT_EQ(to_string(a / d), to_string(A / d));
+    EXPECT_EQ(to_string(a % d), to_string(A % d));
+    EXPECT_EQ(to_string(-a / d), to_string(-A / d));
+  }
+}
+
+TEST(correctness_random, divexact) {
+  std::default_random_engine rng(322);
+  for (std::pair<size_t, size_t> sizes : {std::make_pair(100, 3000), std::make_pair(3000, 100),
+                                          std::make_pair(6000, 6000), std::make_pair(40000, 30000),
+                                          std::make_pair(2000, 50000)}) {
+    big_integer_gmp a, b;
+    a.random(sizes.first, rng);
+    b.random(sizes.second, rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b)) << 100;
+    big_integer C = A * B;
+    EXPECT_EQ(A, big_integer(C).divexact(B));
+    EXPECT_EQ(-B, big_integer(C).divexact(-A));
+  }
+  EXPECT_EQ(0, big_integer(0).divexact(7));
+  EXPECT_THROW(big_integer(5).divexact(0), std::runtime_error);
+}
+
+TEST(correctness_random, big_divisor) {
+  std::default_random_engine rng(322);
+  for (size_t divisor_size : {20, 64, 1000, 5000}) {
+    big_integer_gmp b;
+    b.random(divisor_size, rng);
+    for (big_integer B : {big_integer(to_string(b)), -big_integer(to_string(b))}) {
+      big_divisor D(B);
+      EXPECT_EQ(B, D.value());
+      for (size_t size : {divisor_size / 2, divisor_size, divisor_size * 2, divisor_size * 7}) {
+        big_integer_gmp a;
+        a.random(size, rng);
+        for (big_integer A : {big_integer(to_string(a)), -big_integer(to_string(a))}) {
+          EXPECT_EQ(A / B, A / D);
+          EXPECT_EQ(A % B, A % D);
+        }
+      }
+    }
+  }
+  EXPECT_THROW(big_divisor(0), std::runtime_error);
+}
+
+TEST(correctness_random, to_string_large) {
+  std::default_random_engine rng(7);
+  for (size_t size : {1000, 5000, 30000, 200000}) {
+    big_integer_gmp a;
+    a.random(size, rng);
+    std::string s = to_string(a);
+    EXPECT_EQ(s, to_string(big_integer(s)));
+    EXPECT_EQ(s[0] == '-' ? s.substr(1) : "-" + s, to_string(-big_integer(s)));
+  }
+
+  std::string p = "1" + std::string(20000, '0');
+  EXPECT_EQ(p, to_string(big_integer(p)));
+  EXPECT_EQ(p + "1", to_string(big_integer(p + "1")));
+  EXPECT_EQ(std::string(20000, '9'), to_string(big_integer(p) - 1));
+}
+
+TEST(correctness_random, from_string_large) {
+  std::default_random_engine rng(8);
+  for (size_t size : {2000, 20000, 300000}) {
+    big_integer_gmp a;
+    a.random(size, rng);
+    big_integer A(to_string(a));
+    EXPECT_EQ(to_string(a * a), to_string(A * A));
+    big_integer P = A < 0 ? -A : A;
+    EXPECT_EQ(P, big_integer(std::string(5000, '0') + to_string(P)));
+  }
+  EXPECT_EQ(big_integer(1) << 100000, big_integer(to_string(big_integer(1) << 100000)));
+}
+
+TEST(correctness_random, div_recursive) {
+  std::default_random_engine rng(322);
+  for (std::pair<size_t, size_t> sizes : {std::make_pair(8000, 4000), std::make_pair(20000, 6000),
+                                          std::make_pair(30000, 25000), std::make_pair(60000, 3000)}) {
+    big_integer_gmp a, b;
+    a.random(sizes.first, rng);
+    b.random(sizes.second, rng);
+    big_integer A = big_integer(to_string(a));
+    big_integer B = big_integer(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+    EXPECT_EQ(to_string(-a / b), to_string(-A / B));
+    EXPECT_EQ(to_string(a % -b), to_string(A % -B));
+  }
+
+  // divisors with many all-ones limbs give maximal quotient estimates
+  big_integer B = (big_integer(1) << 12000) - 1;
+  big_integer Q = (big_integer(1) << 9000) - 3;
+  big_integer R = B - 1;
+  big_integer A = B * Q + R;
+  EXPECT_EQ(A / B, Q);
+  EXPECT_EQ(A % B, R);
+}
+
+struct big_integer_test_access {
+  // a / b and a % b by Newton reciprocal for a >= b > 0, the recursion stops at threshold limbs
+  static std::tuple<big_integer, big_integer> newton_divide(big_integer a, big_integer b, size_t threshold) {
+    return a.push_zero().newton_divide(b.push_zero(), threshold);
+  }
+};
+
+TEST(correctness_random, div_newton) {
+  // a lower threshold reaches the reciprocal recursion with short operands
+  std::default_random_engine rng(322);
+  for (size_t bits : {3000, 9000}) {
+    for (size_t ratio : {2, 5}) {
+      std::default_random_engine rng_copy = rng;
+      big_integer_gmp a = rand_bits<big_integer_gmp>(bits * ratio, rng_copy);
+      big_integer_gmp b = rand_bits<big_integer_gmp>(bits, rng_copy);
+      big_integer A = rand_bits<big_integer>(bits * ratio, rng);
+      big_integer B = rand_bits<big_integer>(bits, rng);
+
+      big_integer Q, R;
+      std::tie(Q, R) = big_integer_test_access::newton_divide(A, B, 16);
+      EXPECT_TRUE(0 <= R && R < B);
+      EXPECT_EQ(to_string(a / b), to_string(Q));
+      EXPECT_EQ(to_string(a % b), to_string(R));
+    }
+  }
+}
+
 TEST(correctness_random, bitwise) {
   std::default_random_engine rng(42);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -0,0 +1,152 @@
+#include "buffer_pool.h"
+
+#include <mutex>
+#include <new>
+
+namespace buffer_pool {
+
+namespace {
+
+const size_t CLASSES = 12;
+static_assert((MIN_CLASS_BYTES << (CLASSES - 1)) == MAX_CLASS_BYTES, "CLASSES should cover MIN_CLASS_BYTES..MAX_CLASS_BYTES");
+
+// a free block, the first one of a batch also links the batches of the depot
+struct free_block {
+    free_block* next;
+    free_block* next_batch;
+    size_t batch_size;
+};
+static_assert(sizeof(free_block) <= MIN_CLASS_BYTES, "a free block should fit in the smallest class");
+
+struct free_list {
+    free_block* head;
+    size_t size;
+
+    void push(free_block* block) {
+        block->next = head;
+        head = block;
+        size++;
+    }
+
+    free_block* pop() {
+        free_block* block = head;
+        head = block->next;
+        size--;
+        return block;
+    }
+};
+
+// never destroyed, so that blocks freed by destructors of static objects still have a place to go
+struct depot {
+    std::mutex lock;
+    free_block* batches[CLASSES] = {};
+};
+
+depot& shared_depot() {
+    static depot* res = new depot();
+    return *res;
+}
+
+// trivially destructible, so that it stays usable while other thread_local objects are destroyed
+struct cache {
+    free_list lists[CLASSES];
+    // set when the thread gave its blocks back, later frees go to the depot directly
+    bool closed;
+};
+
+thread_local cache local;
+
+void give_batch(size_t c, size_t n) {
+    free_list& list = local.lists[c];
+    free_list batch = {nullptr, 0};
+    while (batch.size < n) {
+        batch.push(list.pop());
+    }
+    batch.head->batch_size = batch.size;
+
+    depot& d = shared_depot();
+    std::lock_guard<std::mutex> guard(d.lock);
+    batch.head->next_batch = d.batches[c];
+    d.batches[c] = batch.head;
+}
+
+struct cache_owner {
+    ~cache_owner() {
+        for (size_t c = 0; c < CLASSES; c++) {
+            if (local.lists[c].size != 0) {
+                give_batch(c, local.lists[c].size);
+            }
+        }
+        local.closed = true;
+    }
+};
+
+// its destructor returns the blocks of a finished thread to the depot
+thread_local cache_owner owner;
+
+// called when blocks enter the cache, the first call in a thread registers the destructor of owner
+void open_cache() {
+    static_cast<void>(owner);
+}
+
+bool take_batch(size_t c) {
+    depot& d = shared_depot();
+    std::lock_guard<std::mutex> guard(d.lock);
+    free_block* batch = d.batches[c];
+    if (batch == nullptr) {
+        return false;
+    }
+    d.batches[c] = batch->next_batch;
+    local.lists[c].head = batch;
+    local.lists[c].size = batch->batch_size;
+    open_cache();
+    return true;
+}
+
+size_t class_of(size_t bytes) {
+    size_t c = 0;
+    while ((MIN_CLASS_BYTES << c) < bytes) {
+        c++;
+    }
+    return c;
+}
+
+}
+
+size_t block_size(size_t bytes) {
+    return bytes > MAX_CLASS_BYTES ? bytes : MIN_CLASS_BYTES << class_of(bytes);
+}
+
+void* allocate(size_t bytes) {
+    if (bytes > MAX_CLASS_BYTES) {
+        return operator new(bytes);
+    }
+
+    size_t c = class_of(bytes);
+    if (local.lists[c].size != 0 || (!local.closed && take_batch(c))) {
+        return local.lists[c].pop();
+    }
+    return operator new(MIN_CLASS_BYTES << c);
+}
+
+void deallocate(void* block, size_t bytes) {
+    if (bytes > MAX_CLASS_BYTES) {
+        operator delete(block);
+        return;
+    }
+
+    size_t c = class_of(bytes);
+    free_list& list = local.lists[c];
+    list.push(static_cast<free_block*>(block));
+    if (local.closed) {
+        give_batch(c, 1);
+        return;
+    }
+
+    open_cache();
+    if (list.size > CACHE_SIZE) {
+        give_batch(c, CACHE_SIZE / 2);
+    }
+}
+
+}
@@ -0,0 +1,23 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <cstddef>
+
+// Blocks for buffer in size classes of powers of two.
+// Every thread keeps freed blocks of each class in a small cache and exchanges
+// batches of them with a depot shared by all threads, so a block may be freed by any thread.
+// Blocks larger than the largest class go to operator new.
+namespace buffer_pool {
+    static const size_t MIN_CLASS_BYTES = 32;
+    static const size_t MAX_CLASS_BYTES = static_cast<size_t>(1) << 16;
+    // blocks a thread keeps per class, half of them move to the depot when there are more
+    static const size_t CACHE_SIZE = 64;
+
+    // bytes of the block given for a request of bytes
+    size_t block_size(size_t bytes);
+    void* allocate(size_t bytes);
+    // bytes may be anything from the original request up to its block_size
+    void deallocate(void* block, size_t bytes);
+}
+
+#endif // BUFFER_POOL_H
@@ -3,9 +3,68 @@
 
 #include <cstddef>
 #include <algorithm>
+#include <atomic>
+#include <new>
 #include <type_traits>
+#ifdef BIG_INTEGER_BUFFER_POOL
+#include "buffer_pool.h"
+#endif
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+#include "memory_resource.h"
+#endif
 
-template <typename T>
+// reference counter of a buffer whose copies stay in one thread
+struct single_thread_count {
+    explicit single_thread_count(size_t value) : value(value) {}
+
+    void increment() {
+        value++;
+    }
+
+    // returns true if the last reference was dropped
+    bool decrement() {
+        return --value == 0;
+    }
+
+    size_t load() const {
+        return value;
+    }
+
+private:
+    size_t value;
+};
+
+// reference counter of a buffer whose copies may be used by different threads
+struct atomic_count {
+    explicit atomic_count(size_t value) : value(value) {}
+
+    void increment() {
+        // a new reference is made from an existing one, so nothing has to be published
+        value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool decrement() {
+        // no other thread has a reference to share, so the buffer is ours without an atomic write
+        if (value.load(std::memory_order_acquire) == 1) {
+            return true;
+        }
+        // release our writes to whoever frees the buffer, the last one acquires all of them
+        if (value.fetch_sub(1, std::memory_order_release) == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+
+    size_t load() const {
+        return value.load(std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<size_t> value;
+};
+
+template <typename T, typename Count = single_thread_count>
 struct buffer {
     static_assert(std::is_trivially_constructible<T>::value, "T should be trivially constructible");
     static_assert(std::is_trivially_destructible<T>::value, "T should be trivially destructible");
@@ -17,6 +76,10 @@ struct buffer {
 
     static buffer* allocate_buffer(size_t cap);
     static buffer* allocate_buffer(size_t cap, T const& e);
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // takes the block from resource, nullptr for operator new
+    static buffer* allocate_buffer(memory_resource* resource, size_t cap);
+#endif
 
     buffer* copy_and_unshare(size_t new_cap, size_t size);
 
@@ -25,51 +88,109 @@ struct buffer {
 
     bool not_unique() const;
 
-    size_t count;
+    Count count;
     size_t capacity;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // where the block came from, copies made on a write take theirs from it too
+    memory_resource* resource;
+#endif
     T values[];
+
+private:
+    static buffer* allocate_default(size_t cap);
 };
 
-template <typename T>
-buffer<T>* buffer<T>::allocate_buffer(size_t cap) {
-    buffer* res = reinterpret_cast<buffer*>(operator new(sizeof(buffer<T>) + cap * sizeof(T)));
-    res->count = 1;
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::allocate_buffer(size_t cap) {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    return allocate_buffer(nullptr, cap);
+#else
+    return allocate_default(cap);
+#endif
+}
+
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::allocate_buffer(memory_resource* resource, size_t cap) {
+    buffer* res;
+    if (resource == nullptr) {
+        res = allocate_default(cap);
+    } else {
+        res = reinterpret_cast<buffer*>(resource->allocate(sizeof(buffer) + cap * sizeof(T)));
+        new (&res->count) Count(1);
+        res->capacity = cap;
+    }
+    res->resource = resource;
+    return res;
+}
+#endif
+
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::allocate_default(size_t cap) {
+#ifdef BIG_INTEGER_BUFFER_POOL
+    // the rest of the pooled block becomes spare capacity
+    size_t bytes = buffer_pool::block_size(sizeof(buffer) + cap * sizeof(T));
+    buffer* res = reinterpret_cast<buffer*>(buffer_pool::allocate(bytes));
+    cap = (bytes - sizeof(buffer)) / sizeof(T);
+#else
+    buffer* res = reinterpret_cast<buffer*>(operator new(sizeof(buffer) + cap * sizeof(T)));
+#endif
+    new (&res->count) Count(1);
     res->capacity = cap;
     return res;
 }
 
-template <typename T>
-buffer<T>* buffer<T>::allocate_buffer(size_t cap, T const& e) {
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::allocate_buffer(size_t cap, T const& e) {
     buffer* buf = allocate_buffer(cap);
     std::fill(buf->values, buf->values + cap, e);
     return buf;
 }
 
-template <typename T>
-buffer<T>* buffer<T>::copy_and_unshare(size_t new_cap, size_t size) {
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::copy_and_unshare(size_t new_cap, size_t size) {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    buffer* res = allocate_buffer(resource, new_cap);
+#else
     buffer* res = allocate_buffer(new_cap);
+#endif
     std::copy(values, values + size, res->values);
     unshare();
     return res;
 }
 
-template <typename T>
-void buffer<T>::unshare() {
-    count--;
-    if (count == 0) {
+template <typename T, typename Count>
+void buffer<T, Count>::unshare() {
+    if (count.decrement()) {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+        if (resource != nullptr) {
+            resource->deallocate(this, sizeof(buffer) + capacity * sizeof(T));
+            return;
+        }
+#endif
+#ifdef BIG_INTEGER_BUFFER_POOL
+        buffer_pool::deallocate(this, sizeof(buffer) + capacity * sizeof(T));
+#else
         operator delete(this);
+#endif
     }
 }
 
-template <typename T>
-buffer<T>* buffer<T>::share() {
-    count++;
+template <typename T, typename Count>
+buffer<T, Count>* buffer<T, Count>::share() {
+    count.increment();
     return this;
 }
 
-template <typename T>
-bool buffer<T>::not_unique() const {
-    return count > 1;
+template <typename T, typename Count>
+bool buffer<T, Count>::not_unique() const {
+    return count.load() > 1;
 }
 
+// buffers with a fixed counter, to be passed where a template of one type is expected
+template <typename T>
+using single_thread_buffer = buffer<T, single_thread_count>;
+template <typename T>
+using atomic_buffer = buffer<T, atomic_count>;
+
 #endif // COW_BUFFER_H
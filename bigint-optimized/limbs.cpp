@@ -0,0 +1,580 @@
+#include "limbs.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace limbs {
+
+limb_t add_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t x = a[i] + carry;
+        carry = x < carry;
+        limb_t y = x + b[i];
+        carry += y < x;
+        r[i] = y;
+    }
+    return carry;
+}
+
+limb_t sub_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t x = a[i] - borrow;
+        borrow = x > a[i];
+        limb_t y = x - b[i];
+        borrow += y > x;
+        r[i] = y;
+    }
+    return borrow;
+}
+
+limb_t add_in(limb_t* r, size_t n, limb_t const* a, size_t m) {
+    limb_t carry = add_n(r, r, a, m);
+    for (size_t i = m; carry && i < n; i++) {
+        carry = ++r[i] == 0;
+    }
+    return carry;
+}
+
+limb_t sub_in(limb_t* r, size_t n, limb_t const* a, size_t m) {
+    limb_t borrow = sub_n(r, r, a, m);
+    for (size_t i = m; borrow && i < n; i++) {
+        borrow = r[i]-- == 0;
+    }
+    return borrow;
+}
+
+limb_t mul_1(limb_t* r, limb_t const* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        double_limb_t res = static_cast<double_limb_t>(a[i]) * b + carry;
+        r[i] = static_cast<limb_t>(res);
+        carry = static_cast<limb_t>(res >> LIMB_BITS);
+    }
+    return carry;
+}
+
+limb_t muladd_1(limb_t* r, limb_t const* a, size_t n, limb_t b, limb_t c) {
+    limb_t carry = c;
+    for (size_t i = 0; i < n; i++) {
+        double_limb_t res = static_cast<double_limb_t>(a[i]) * b + carry;
+        r[i] = static_cast<limb_t>(res);
+        carry = static_cast<limb_t>(res >> LIMB_BITS);
+    }
+    return carry;
+}
+
+limb_t addmul_1(limb_t* r, limb_t const* a, size_t n, limb_t b) {
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        double_limb_t res = static_cast<double_limb_t>(a[i]) * b + r[i] + carry;
+        r[i] = static_cast<limb_t>(res);
+        carry = static_cast<limb_t>(res >> LIMB_BITS);
+    }
+    return carry;
+}
+
+limb_t submul_1(limb_t* r, limb_t const* a, size_t n, limb_t b) {
+    limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        double_limb_t res = static_cast<double_limb_t>(a[i]) * b + borrow;
+        limb_t low = static_cast<limb_t>(res);
+        borrow = static_cast<limb_t>(res >> LIMB_BITS) + (r[i] < low);
+        r[i] -= low;
+    }
+    return borrow;
+}
+
+limb_t lshift(limb_t* r, limb_t const* a, size_t n, unsigned s) {
+    limb_t out = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t e = a[i];
+        r[i] = (e << s) | out;
+        out = e >> (LIMB_BITS - s);
+    }
+    return out;
+}
+
+limb_t rshift(limb_t* r, limb_t const* a, size_t n, unsigned s) {
+    limb_t out = 0;
+    for (size_t i = n; i > 0; i--) {
+        limb_t e = a[i - 1];
+        r[i - 1] = (e >> s) | out;
+        out = e << (LIMB_BITS - s);
+    }
+    return out;
+}
+
+limb_t inverse(limb_t d) {
+    // d * d == 1 mod 8, every step doubles the number of correct bits
+    limb_t inv = d;
+    for (int bits = 3; bits < LIMB_BITS; bits *= 2) {
+        inv *= 2 - d * inv;
+    }
+    return inv;
+}
+
+void divexact_1(limb_t* r, limb_t const* a, size_t n, limb_t d) {
+    unsigned s = 0;
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+    if (s != 0) {
+        rshift(r, a, n, s);
+        a = r;
+    }
+
+    limb_t inv = inverse(d);
+    limb_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t e = a[i] - borrow;
+        borrow = e > a[i];
+        limb_t q = e * inv;
+        r[i] = q;
+        borrow += static_cast<limb_t>((static_cast<double_limb_t>(q) * d) >> LIMB_BITS);
+    }
+}
+
+int compare(limb_t const* a, limb_t const* b, size_t n) {
+    for (size_t i = n; i > 0; i--) {
+        if (a[i - 1] != b[i - 1]) {
+            return a[i - 1] < b[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+void mul_basecase(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    r[n] = mul_1(r, a, n, b[0]);
+    for (size_t j = 1; j < m; j++) {
+        r[n + j] = addmul_1(r + j, a, n, b[j]);
+    }
+}
+
+void sqr_basecase(limb_t* r, limb_t const* a, size_t n) {
+    // cross products a[i] * a[j], i < j, are computed once and doubled
+    std::fill(r, r + 2 * n, 0);
+    for (size_t i = 0; i + 1 < n; i++) {
+        r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    lshift(r, r, 2 * n, 1);
+
+    limb_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        double_limb_t square = static_cast<double_limb_t>(a[i]) * a[i];
+        double_limb_t low = static_cast<double_limb_t>(r[2 * i]) + static_cast<limb_t>(square) + carry;
+        double_limb_t high = static_cast<double_limb_t>(r[2 * i + 1]) + static_cast<limb_t>(square >> LIMB_BITS)
+                           + static_cast<limb_t>(low >> LIMB_BITS);
+        r[2 * i] = static_cast<limb_t>(low);
+        r[2 * i + 1] = static_cast<limb_t>(high);
+        carry = static_cast<limb_t>(high >> LIMB_BITS);
+    }
+}
+
+namespace {
+
+// r = |a - b|, n >= m, returns true if a < b
+bool abs_diff(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    bool less = std::all_of(a + m, a + n, [](limb_t e) { return e == 0; })
+                && compare(a, b, m) < 0;
+    if (less) {
+        sub_n(r, b, a, m);
+        std::fill(r + m, r + n, 0);
+    } else {
+        std::copy(a, a + n, r);
+        sub_in(r, n, b, m);
+    }
+    return less;
+}
+
+size_t karatsuba_scratch_size(size_t n) {
+    size_t size = 0;
+    while (n >= KARATSUBA_THRESHOLD) {
+        size_t h = (n + 1) / 2;
+        size += 6 * h + 1;
+        n = h;
+    }
+    return size;
+}
+
+// r[0..2n) = a * b, scratch has karatsuba_scratch_size(n) limbs
+// a == b computes square
+void karatsuba(limb_t* r, limb_t const* a, limb_t const* b, size_t n, limb_t* scratch) {
+    if (n < KARATSUBA_THRESHOLD) {
+        if (a == b) {
+            sqr_basecase(r, a, n);
+        } else {
+            mul_basecase(r, a, n, b, n);
+        }
+        return;
+    }
+
+    // a = a1 * B^h + a0, b = b1 * B^h + b0
+    // a * b = z2 * B^2h + (z0 + z2 - (a0 - a1)(b0 - b1)) * B^h + z0
+    size_t h = (n + 1) / 2;
+    size_t l = n - h;
+    limb_t* t = scratch;
+    limb_t* u = t + h;
+    limb_t* m = u + h;
+    limb_t* mid = m + 2 * h;
+    limb_t* next = mid + 2 * h + 1;
+
+    bool m_negative = false;
+    if (a == b) {
+        abs_diff(t, a, h, a + h, l);
+        u = t;
+    } else {
+        m_negative = abs_diff(t, a, h, a + h, l) != abs_diff(u, b, h, b + h, l);
+    }
+    karatsuba(m, t, u, h, next);
+    karatsuba(r, a, b, h, next);
+    karatsuba(r + 2 * h, a + h, b + h, l, next);
+
+    std::copy(r, r + 2 * h, mid);
+    mid[2 * h] = 0;
+    add_in(mid, 2 * h + 1, r + 2 * h, 2 * l);
+    if (m_negative) {
+        add_in(mid, 2 * h + 1, m, 2 * h);
+    } else {
+        sub_in(mid, 2 * h + 1, m, 2 * h);
+    }
+    add_in(r + h, 2 * n - h, mid, std::min(2 * h + 1, 2 * n - h));
+}
+
+// r[0..n) += a[0..m) * c, m <= n, returns carry
+limb_t addmul_in(limb_t* r, size_t n, limb_t const* a, size_t m, limb_t c) {
+    limb_t carry = addmul_1(r, a, m, c);
+    return m == n ? carry : add_in(r + m, n - m, &carry, 1);
+}
+
+// Toom interpolation keeps intermediate values as fixed width two's complement numbers,
+// so that additions, subtractions and exact divisions are simply done modulo B^n
+void negate(limb_t* x, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        x[i] = ~x[i];
+    }
+    limb_t one = 1;
+    add_in(x, n, &one, 1);
+}
+
+void arithmetic_rshift(limb_t* x, size_t n, unsigned s) {
+    bool negative = x[n - 1] >> (LIMB_BITS - 1);
+    rshift(x, x, n, s);
+    if (negative) {
+        x[n - 1] |= ~(std::numeric_limits<limb_t>::max() >> s);
+    }
+}
+
+// r[0..len) = a[0..n) zero extended
+void extend(limb_t* r, size_t len, limb_t const* a, size_t n) {
+    std::copy(a, a + n, r);
+    std::fill(r + n, r + len, 0);
+}
+
+// r[0..2n) += c[i] * B^(i * k) for every coefficient c[i] of width len
+void toom_recompose(limb_t* r, size_t n, size_t k, scratch_vector<limb_t> const& c, size_t len, size_t points) {
+    for (size_t i = 1; i + 1 < points; i++) {
+        size_t offset = i * k;
+        add_in(r + offset, 2 * n - offset, c.data() + i * len, std::min(len, 2 * n - offset));
+    }
+}
+
+// a = a2 * B^2k + a1 * B^k + a0, evaluates at 1, -1 and 2 into k + 1 limbs each
+// returns true if value at -1 is negative (its absolute value is stored)
+bool toom3_evaluate(limb_t* e1, limb_t* em1, limb_t* e2, limb_t const* a, size_t k, size_t top) {
+    scratch_vector<limb_t> even(k + 1);
+    extend(even.data(), k + 1, a, k);
+    add_in(even.data(), k + 1, a + 2 * k, top);
+
+    std::copy(even.begin(), even.end(), e1);
+    add_in(e1, k + 1, a + k, k);
+    bool negative = abs_diff(em1, even.data(), k + 1, a + k, k);
+
+    extend(e2, k + 1, a, k);
+    addmul_in(e2, k + 1, a + k, k, 2);
+    addmul_in(e2, k + 1, a + 2 * k, top, 4);
+    return negative;
+}
+
+// r[0..2n) = a * b, points 0, 1, -1, 2, inf
+void toom3(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    size_t k = (n + 2) / 3;
+    size_t top = n - 2 * k;
+    size_t len = 2 * k + 2;
+
+    // squaring evaluates the operand once, so that pointwise products are squares too
+    scratch_vector<limb_t> ea(3 * (k + 1));
+    scratch_vector<limb_t> eb(a == b ? 0 : 3 * (k + 1));
+    limb_t* pa = ea.data();
+    limb_t* pb = a == b ? pa : eb.data();
+    bool sa = toom3_evaluate(pa, pa + k + 1, pa + 2 * (k + 1), a, k, top);
+    bool sb = a == b ? sa : toom3_evaluate(pb, pb + k + 1, pb + 2 * (k + 1), b, k, top);
+    bool wm1_negative = sa != sb;
+
+    // w[i] = e_a(x_i) * e_b(x_i) for x_i = 1, -1, 2
+    scratch_vector<limb_t> w(3 * len);
+    for (size_t i = 0; i < 3; i++) {
+        mul_n(w.data() + i * len, pa + i * (k + 1), pb + i * (k + 1), k + 1);
+    }
+    limb_t* w1 = w.data();
+    limb_t* wm1 = w1 + len;
+    limb_t* w2 = wm1 + len;
+    if (wm1_negative) {
+        negate(wm1, len);
+    }
+
+    std::fill(r, r + 2 * n, 0);
+    mul_n(r, a, b, k);
+    mul_n(r + 4 * k, a + 2 * k, b + 2 * k, top);
+
+    scratch_vector<limb_t> c(5 * len);
+    limb_t* c0 = c.data();
+    limb_t* c1 = c0 + len;
+    limb_t* c2 = c1 + len;
+    limb_t* c3 = c2 + len;
+    limb_t* c4 = c3 + len;
+    extend(c0, len, r, 2 * k);
+    extend(c4, len, r + 4 * k, 2 * top);
+
+    // c1 + c3 = (w1 - wm1) / 2
+    sub_n(c1, w1, wm1, len);
+    arithmetic_rshift(c1, len, 1);
+    // c2 = (w1 + wm1) / 2 - c0 - c4
+    add_n(c2, w1, wm1, len);
+    arithmetic_rshift(c2, len, 1);
+    sub_n(c2, c2, c0, len);
+    sub_n(c2, c2, c4, len);
+    // c1 + 4 * c3 = (w2 - c0 - 4 * c2 - 16 * c4) / 2
+    sub_n(w2, w2, c0, len);
+    submul_1(w2, c2, len, 4);
+    submul_1(w2, c4, len, 16);
+    arithmetic_rshift(w2, len, 1);
+    // c3 = ((c1 + 4 * c3) - (c1 + c3)) / 3
+    sub_n(c3, w2, c1, len);
+    divexact_1(c3, c3, len, 3);
+    sub_n(c1, c1, c3, len);
+
+    toom_recompose(r, n, k, c, len, 5);
+}
+
+// a = a3 * B^3k + a2 * B^2k + a1 * B^k + a0, evaluates at 1, -1, 2, -2 and 3 into k + 1 limbs each
+// returns signs of values at -1 and -2 (their absolute values are stored)
+std::pair<bool, bool> toom4_evaluate(limb_t* e, limb_t const* a, size_t k, size_t top) {
+    limb_t* e1 = e;
+    limb_t* em1 = e1 + k + 1;
+    limb_t* e2 = em1 + k + 1;
+    limb_t* em2 = e2 + k + 1;
+    limb_t* e3 = em2 + k + 1;
+
+    scratch_vector<limb_t> even(k + 1);
+    scratch_vector<limb_t> odd(k + 1);
+
+    extend(even.data(), k + 1, a, k);
+    add_in(even.data(), k + 1, a + 2 * k, k);
+    extend(odd.data(), k + 1, a + k, k);
+    add_in(odd.data(), k + 1, a + 3 * k, top);
+    add_n(e1, even.data(), odd.data(), k + 1);
+    bool m1 = abs_diff(em1, even.data(), k + 1, odd.data(), k + 1);
+
+    extend(even.data(), k + 1, a, k);
+    addmul_in(even.data(), k + 1, a + 2 * k, k, 4);
+    std::fill(odd.begin(), odd.end(), 0);
+    addmul_in(odd.data(), k + 1, a + k, k, 2);
+    addmul_in(odd.data(), k + 1, a + 3 * k, top, 8);
+    add_n(e2, even.data(), odd.data(), k + 1);
+    bool m2 = abs_diff(em2, even.data(), k + 1, odd.data(), k + 1);
+
+    extend(e3, k + 1, a, k);
+    addmul_in(e3, k + 1, a + k, k, 3);
+    addmul_in(e3, k + 1, a + 2 * k, k, 9);
+    addmul_in(e3, k + 1, a + 3 * k, top, 27);
+    return {m1, m2};
+}
+
+// r[0..2n) = a * b, points 0, 1, -1, 2, -2, 3, inf
+void toom4(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    size_t k = (n + 3) / 4;
+    size_t top = n - 3 * k;
+    size_t len = 2 * k + 2;
+
+    scratch_vector<limb_t> ea(5 * (k + 1));
+    scratch_vector<limb_t> eb(a == b ? 0 : 5 * (k + 1));
+    limb_t* pa = ea.data();
+    limb_t* pb = a == b ? pa : eb.data();
+    std::pair<bool, bool> sa = toom4_evaluate(pa, a, k, top);
+    std::pair<bool, bool> sb = a == b ? sa : toom4_evaluate(pb, b, k, top);
+
+    // w[i] = e_a(x_i) * e_b(x_i) for x_i = 1, -1, 2, -2, 3
+    scratch_vector<limb_t> w(5 * len);
+    for (size_t i = 0; i < 5; i++) {
+        mul_n(w.data() + i * len, pa + i * (k + 1), pb + i * (k + 1), k + 1);
+    }
+    limb_t* w1 = w.data();
+    limb_t* wm1 = w1 + len;
+    limb_t* w2 = wm1 + len;
+    limb_t* wm2 = w2 + len;
+    limb_t* w3 = wm2 + len;
+    if (sa.first != sb.first) {
+        negate(wm1, len);
+    }
+    if (sa.second != sb.second) {
+        negate(wm2, len);
+    }
+
+    std::fill(r, r + 2 * n, 0);
+    mul_n(r, a, b, k);
+    mul_n(r + 6 * k, a + 3 * k, b + 3 * k, top);
+
+    scratch_vector<limb_t> c(7 * len);
+    limb_t* c0 = c.data();
+    limb_t* c1 = c0 + len;
+    limb_t* c2 = c1 + len;
+    limb_t* c3 = c2 + len;
+    limb_t* c4 = c3 + len;
+    limb_t* c5 = c4 + len;
+    limb_t* c6 = c5 + len;
+    extend(c0, len, r, 2 * k);
+    extend(c6, len, r + 6 * k, 2 * top);
+
+    // c1 + c3 + c5 = (w1 - wm1) / 2, c2 + c4 = (w1 + wm1) / 2 - c0 - c6
+    sub_n(c1, w1, wm1, len);
+    arithmetic_rshift(c1, len, 1);
+    add_n(c2, w1, wm1, len);
+    arithmetic_rshift(c2, len, 1);
+    sub_n(c2, c2, c0, len);
+    sub_n(c2, c2, c6, len);
+    // c1 + 4 * c3 + 16 * c5 = (w2 - wm2) / 4, c2 + 4 * c4 = ((w2 + wm2) / 2 - c0 - 64 * c6) / 4
+    sub_n(c3, w2, wm2, len);
+    arithmetic_rshift(c3, len, 2);
+    add_n(c4, w2, wm2, len);
+    arithmetic_rshift(c4, len, 1);
+    sub_n(c4, c4, c0, len);
+    submul_1(c4, c6, len, 64);
+    arithmetic_rshift(c4, len, 2);
+    // c4 = ((c2 + 4 * c4) - (c2 + c4)) / 3
+    sub_n(c4, c4, c2, len);
+    divexact_1(c4, c4, len, 3);
+    sub_n(c2, c2, c4, len);
+    // c1 + 9 * c3 + 81 * c5 = (w3 - c0 - 9 * c2 - 81 * c4 - 729 * c6) / 3
+    sub_n(w3, w3, c0, len);
+    submul_1(w3, c2, len, 9);
+    submul_1(w3, c4, len, 81);
+    submul_1(w3, c6, len, 729);
+    divexact_1(w3, w3, len, 3);
+    // c3 + 13 * c5 = (w3 - (c1 + 4 * c3 + 16 * c5)) / 5
+    sub_n(w3, w3, c3, len);
+    divexact_1(w3, w3, len, 5);
+    // c3 + 5 * c5 = ((c1 + 4 * c3 + 16 * c5) - (c1 + c3 + c5)) / 3
+    sub_n(c3, c3, c1, len);
+    divexact_1(c3, c3, len, 3);
+    // c5 = ((c3 + 13 * c5) - (c3 + 5 * c5)) / 8
+    sub_n(c5, w3, c3, len);
+    arithmetic_rshift(c5, len, 3);
+    submul_1(c3, c5, len, 5);
+    sub_n(c1, c1, c3, len);
+    sub_n(c1, c1, c5, len);
+
+    toom_recompose(r, n, k, c, len, 7);
+}
+
+}
+
+void mul_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    if (n < KARATSUBA_THRESHOLD) {
+        if (a == b) {
+            sqr_basecase(r, a, n);
+        } else {
+            mul_basecase(r, a, n, b, n);
+        }
+    } else if (n < TOOM3_THRESHOLD) {
+        scratch_vector<limb_t> scratch(karatsuba_scratch_size(n));
+        karatsuba(r, a, b, n, scratch.data());
+    } else if (n < TOOM4_THRESHOLD) {
+        toom3(r, a, b, n);
+    } else if (n < NTT_THRESHOLD || n > NTT_MAX_SIZE) {
+        toom4(r, a, b, n);
+    } else {
+        mul_ntt(r, a, n, b, n);
+    }
+}
+
+void sqr(limb_t* r, limb_t const* a, size_t n) {
+    mul_n(r, a, a, n);
+}
+
+void mullo_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n) {
+    if (n < KARATSUBA_THRESHOLD) {
+        std::fill(r, r + n, 0);
+        for (size_t j = 0; j < n; j++) {
+            addmul_1(r + j, a, n - j, b[j]);
+        }
+        return;
+    }
+
+    // a_low * b_low in full, cross products only modulo B^h
+    size_t h = n / 2;
+    size_t l = n - h;
+    scratch_vector<limb_t> t(2 * l);
+    mul_n(t.data(), a, b, l);
+    std::copy(t.begin(), t.begin() + n, r);
+    mullo_n(t.data(), a + l, b, h);
+    add_n(r + l, r + l, t.data(), h);
+    mullo_n(t.data(), a, b + l, h);
+    add_n(r + l, r + l, t.data(), h);
+}
+
+void mul(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    if (a == b && n == m) {
+        sqr(r, a, n);
+        return;
+    }
+    if (m == 1) {
+        r[n] = mul_1(r, a, n, b[0]);
+        return;
+    }
+    if (m < KARATSUBA_THRESHOLD) {
+        mul_basecase(r, a, n, b, m);
+        return;
+    }
+    if (n == m) {
+        mul_n(r, a, b, n);
+        return;
+    }
+    if (m >= NTT_THRESHOLD && m <= NTT_MAX_SIZE && n + m <= 8 * NTT_MAX_SIZE) {
+        // transform length depends on n + m only, no need to split a
+        mul_ntt(r, a, n, b, m);
+        return;
+    }
+
+    if (2 * n <= 3 * m) {
+        // almost balanced, padding b costs less than an extra product
+        scratch_vector<limb_t> padded(n, 0);
+        scratch_vector<limb_t> res(2 * n);
+        std::copy(b, b + m, padded.begin());
+        mul_n(res.data(), a, padded.data(), n);
+        std::copy(res.begin(), res.begin() + n + m, r);
+        return;
+    }
+
+    // a is sliced into chunks of m limbs, each one is a balanced product with b
+    scratch_vector<limb_t> chunk(2 * m);
+    mul_n(r, a, b, m);
+    size_t offset = m;
+    for (; offset + m <= n; offset += m) {
+        mul_n(chunk.data(), a + offset, b, m);
+        std::fill(r + offset + m, r + offset + 2 * m, 0);
+        add_in(r + offset, 2 * m, chunk.data(), 2 * m);
+    }
+    if (offset < n) {
+        size_t rest = n - offset;
+        mul(chunk.data(), b, m, a + offset, rest);
+        std::fill(r + offset + m, r + n + m, 0);
+        add_in(r + offset, m + rest, chunk.data(), m + rest);
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef LIMBS_H
+#define LIMBS_H
+
+#include <cstddef>
+#include "big_integer.h"
+
+// Low-level arithmetic on unsigned little-endian limb arrays.
+// Unless stated otherwise result arrays must not overlap with arguments.
+namespace limbs {
+    using limb_t = big_integer::int_t;
+    using double_limb_t = big_integer::double_int_t;
+
+    static const int LIMB_BITS = big_integer::INT_T_BITS;
+
+    static const size_t KARATSUBA_THRESHOLD = 32;
+    static const size_t TOOM3_THRESHOLD = 128;
+    static const size_t TOOM4_THRESHOLD = 256;
+    static const size_t NTT_THRESHOLD = 8192;
+    static const size_t BZ_THRESHOLD = 64;
+    static const size_t DIVEXACT_THRESHOLD = 64;
+    // big_integer division switches to Newton reciprocal above this divisor and quotient size
+    static const size_t NEWTON_THRESHOLD = 65536;
+    // big_integer decimal conversion splits numbers longer than this many limbs or chunks of digits by powers of ten
+    static const size_t DECIMAL_THRESHOLD = 50;
+    // three prime NTT is exact while the shorter operand has at most 2^21 32-bit pieces
+    static const size_t NTT_MAX_SIZE = (static_cast<size_t>(1) << 21) / (LIMB_BITS / 32);
+
+    // r = a + b, returns carry, r may be equal to a or b
+    limb_t add_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n);
+    // r = a - b, returns borrow, r may be equal to a or b
+    limb_t sub_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n);
+    // r[0..n) += a[0..m), m <= n, returns carry
+    limb_t add_in(limb_t* r, size_t n, limb_t const* a, size_t m);
+    // r[0..n) -= a[0..m), m <= n, returns borrow
+    limb_t sub_in(limb_t* r, size_t n, limb_t const* a, size_t m);
+
+    // r = a * b, returns carry, r may be equal to a
+    limb_t mul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+    // r = a * b + c, returns carry, r may be equal to a
+    limb_t muladd_1(limb_t* r, limb_t const* a, size_t n, limb_t b, limb_t c);
+    // r += a * b, returns carry
+    limb_t addmul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+
+    // r -= a * b, returns borrow
+    limb_t submul_1(limb_t* r, limb_t const* a, size_t n, limb_t b);
+
+    // r = a << s, 0 < s < LIMB_BITS, returns shifted out bits, r may be equal to a
+    limb_t lshift(limb_t* r, limb_t const* a, size_t n, unsigned s);
+    // r = a >> s, 0 < s < LIMB_BITS, returns shifted out bits in the high part of limb, r may be equal to a
+    limb_t rshift(limb_t* r, limb_t const* a, size_t n, unsigned s);
+
+    // inverse of odd d modulo B
+    limb_t inverse(limb_t d);
+    // r = a / d modulo B^n, a must be divisible by d, r may be equal to a
+    void divexact_1(limb_t* r, limb_t const* a, size_t n, limb_t d);
+
+    int compare(limb_t const* a, limb_t const* b, size_t n);
+
+    // r[0..n+m) = a * b, n >= m > 0
+    void mul_basecase(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m);
+    // r[0..2n) = a * a
+    void sqr_basecase(limb_t* r, limb_t const* a, size_t n);
+    // r[0..n+m) = a * b, n >= m > 0, m <= NTT_MAX_SIZE, n + m <= 8 * NTT_MAX_SIZE
+    void mul_ntt(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m);
+    // r[0..2n) = a * b, a == b uses squaring versions of every algorithm
+    void mul_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n);
+    // r[0..2n) = a * a
+    void sqr(limb_t* r, limb_t const* a, size_t n);
+    // r[0..n) = a * b modulo B^n
+    void mullo_n(limb_t* r, limb_t const* a, limb_t const* b, size_t n);
+    // r[0..n+m) = a * b, n >= m > 0
+    void mul(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m);
+
+    // floor((B^2 - 1) / d) - B for d with top bit set
+    limb_t reciprocal_word(limb_t d);
+    // q[0..n) = a / d, returns remainder, q may be equal to a
+    limb_t divrem_1(limb_t* q, limb_t const* a, size_t n, limb_t d);
+    // schoolbook division by normalized b (top bit of b[m - 1] is set), n >= m >= 2
+    // q[0..n-m) = low limbs of a / b, returns the highest quotient limb (0 or 1),
+    // a is replaced with remainder in a[0..m) and zeros above
+    limb_t divrem_basecase(limb_t* q, limb_t* a, size_t n, limb_t const* b, size_t m);
+    // q[0..n-m+1) = a / b, r[0..m) = a % b, n >= m > 0, b[m - 1] != 0
+    // uses Burnikel-Ziegler recursive division for large operands
+    void divrem(limb_t* q, limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m);
+    // x[0..m) = floor((B^(2m) - 1) / d) - B^m for d[0..m) with top bit set
+    void invert(limb_t* x, limb_t const* d, size_t m);
+    // q[0..n-m+1) = a / (d >> s), r[0..m) = a % (d >> s), n >= m, d[0..m) has top bit set, x = invert(d)
+    // Barrett division, costs two multiplications per m limbs of a
+    void divrem_preinv(limb_t* q, limb_t* r, limb_t const* a, size_t n,
+                       limb_t const* d, size_t m, unsigned s, limb_t const* x);
+    // q[0..n-m+1) = a / b, n >= m > 0, b[m - 1] != 0, a must be divisible by b
+    // Hensel division from the low limbs, 2-adic Newton inverse for large quotients
+    void divexact(limb_t* q, limb_t const* a, size_t n, limb_t const* b, size_t m);
+}
+
+#endif // LIMBS_H
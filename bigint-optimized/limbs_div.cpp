@@ -0,0 +1,475 @@
+#include "limbs.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace limbs {
+
+namespace {
+
+// q = (u1, u0) / d, r = remainder for normalized d and u1 < d
+// with v = reciprocal_word(d), Moller-Granlund algorithm 4
+limb_t div_2by1(limb_t& r, limb_t u1, limb_t u0, limb_t d, limb_t v) {
+    double_limb_t q = static_cast<double_limb_t>(v) * u1 + ((static_cast<double_limb_t>(u1) << LIMB_BITS) | u0);
+    limb_t q1 = static_cast<limb_t>(q >> LIMB_BITS) + 1;
+    limb_t q0 = static_cast<limb_t>(q);
+
+    r = u0 - q1 * d;
+    if (r > q0) {
+        q1--;
+        r += d;
+    }
+    if (r >= d) {
+        q1++;
+        r -= d;
+    }
+    return q1;
+}
+
+// q = (u2, u1, u0) / (d1, d0), (r1, r0) = remainder for (u2, u1) < (d1, d0)
+// with v = reciprocal_3by2(d1, d0), Moller-Granlund algorithm 5
+limb_t div_3by2(limb_t& r1, limb_t& r0, limb_t u2, limb_t u1, limb_t u0, limb_t d1, limb_t d0, limb_t v) {
+    double_limb_t d = (static_cast<double_limb_t>(d1) << LIMB_BITS) | d0;
+    double_limb_t q = static_cast<double_limb_t>(v) * u2 + ((static_cast<double_limb_t>(u2) << LIMB_BITS) | u1);
+    limb_t q1 = static_cast<limb_t>(q >> LIMB_BITS);
+    limb_t q0 = static_cast<limb_t>(q);
+
+    limb_t t1 = u1 - q1 * d1;
+    double_limb_t r = ((static_cast<double_limb_t>(t1) << LIMB_BITS) | u0) - static_cast<double_limb_t>(d0) * q1 - d;
+    q1++;
+    if (static_cast<limb_t>(r >> LIMB_BITS) >= q0) {
+        q1--;
+        r += d;
+    }
+    if (r >= d) {
+        q1++;
+        r -= d;
+    }
+    r1 = static_cast<limb_t>(r >> LIMB_BITS);
+    r0 = static_cast<limb_t>(r);
+    return q1;
+}
+
+// floor((B^3 - 1) / (d1, d0)) - B for normalized d1
+limb_t reciprocal_3by2(limb_t d1, limb_t d0) {
+    limb_t v = reciprocal_word(d1);
+    limb_t p = d1 * v;
+    p += d0;
+    if (p < d0) {
+        v--;
+        if (p >= d1) {
+            v--;
+            p -= d1;
+        }
+        p -= d1;
+    }
+
+    double_limb_t t = static_cast<double_limb_t>(v) * d0;
+    limb_t t1 = static_cast<limb_t>(t >> LIMB_BITS);
+    limb_t t0 = static_cast<limb_t>(t);
+    p += t1;
+    if (p < t1) {
+        v--;
+        if (p > d1 || (p == d1 && t0 >= d0)) {
+            v--;
+        }
+    }
+    return v;
+}
+
+}
+
+limb_t reciprocal_word(limb_t d) {
+    double_limb_t num = (static_cast<double_limb_t>(~d) << LIMB_BITS) | static_cast<limb_t>(~static_cast<limb_t>(0));
+    return static_cast<limb_t>(num / d);
+}
+
+limb_t divrem_1(limb_t* q, limb_t const* a, size_t n, limb_t d) {
+    unsigned s = 0;
+    while ((d << s) >> (LIMB_BITS - 1) == 0) {
+        s++;
+    }
+    d <<= s;
+    limb_t v = reciprocal_word(d);
+
+    // a << s is divided by d << s, shifted limbs are built on the fly
+    limb_t r = s == 0 ? 0 : a[n - 1] >> (LIMB_BITS - s);
+    for (size_t i = n; i > 0; i--) {
+        limb_t u = a[i - 1] << s;
+        if (s != 0 && i > 1) {
+            u |= a[i - 2] >> (LIMB_BITS - s);
+        }
+        q[i - 1] = div_2by1(r, r, u, d, v);
+    }
+    return r >> s;
+}
+
+limb_t divrem_basecase(limb_t* q, limb_t* a, size_t n, limb_t const* b, size_t m) {
+    limb_t high = compare(a + n - m, b, m) >= 0;
+    if (high) {
+        sub_n(a + n - m, a + n - m, b, m);
+    }
+
+    limb_t d1 = b[m - 1];
+    limb_t d0 = b[m - 2];
+    limb_t v = reciprocal_3by2(d1, d0);
+    for (size_t j = n - m; j > 0; j--) {
+        limb_t* r = a + j - 1;
+        limb_t qt;
+        if (r[m] == d1 && r[m - 1] == d0) {
+            qt = static_cast<limb_t>(-1);
+            submul_1(r, b, m, qt);
+        } else {
+            // top three limbs give the exact quotient of top two limbs of b, the rest may borrow once
+            limb_t r1, r0;
+            qt = div_3by2(r1, r0, r[m], r[m - 1], r[m - 2], d1, d0, v);
+            limb_t borrow = submul_1(r, b, m - 2, qt);
+            limb_t borrow0 = r0 < borrow;
+            r[m - 2] = r0 - borrow;
+            r[m - 1] = r1 - borrow0;
+            if (r1 < borrow0) {
+                qt--;
+                add_n(r, r, b, m);
+            }
+        }
+        r[m] = 0;
+        q[j - 1] = qt;
+    }
+    return high;
+}
+
+namespace {
+
+void div_2n_1n(limb_t* q, limb_t* a, limb_t const* b, size_t n);
+
+// q[0..h) = a[0..3h) / b[0..2h), remainder in a[0..2h), a < b * B^h
+void div_3n_2n(limb_t* q, limb_t* a, limb_t const* b, size_t h) {
+    limb_t const* b0 = b;
+    limb_t const* b1 = b + h;
+
+    if (compare(a + 2 * h, b1, h) < 0) {
+        div_2n_1n(q, a + h, b1, h);
+    } else {
+        // a2 == b1, so q = B^h - 1 and (a2, a1) - q * b1 = a1 + b1
+        std::fill(q, q + h, static_cast<limb_t>(-1));
+        std::fill(a + 2 * h, a + 3 * h, 0);
+        a[2 * h] = add_in(a + h, h, b1, h);
+    }
+
+    scratch_vector<limb_t> d(2 * h);
+    mul_n(d.data(), q, b0, h);
+    limb_t borrow = sub_in(a, 3 * h, d.data(), 2 * h);
+    while (borrow) {
+        limb_t one = 1;
+        sub_in(q, h, &one, 1);
+        borrow -= add_in(a, 3 * h, b, 2 * h);
+    }
+}
+
+// q[0..n) = a[0..2n) / b[0..n), remainder in a[0..n), a[n..2n) is zeroed, a < b * B^n
+void div_2n_1n(limb_t* q, limb_t* a, limb_t const* b, size_t n) {
+    if (n % 2 == 1 || n < BZ_THRESHOLD) {
+        divrem_basecase(q, a, 2 * n, b, n);
+        return;
+    }
+
+    size_t h = n / 2;
+    div_3n_2n(q + h, a + h, b, h);
+    div_3n_2n(q, a, b, h);
+}
+
+// Burnikel-Ziegler division, b[m - 1] has top bit set and a[n - 1] < b[m - 1],
+// q[0..n-m) = a / b, a is replaced with remainder in a[0..m)
+void divrem_recursive(limb_t* q, limb_t* a, size_t n, limb_t const* b, size_t m) {
+    // block size n1 = j * 2^k >= m, so that div_2n_1n halves it k times
+    size_t blocks = 1;
+    while (m / blocks >= BZ_THRESHOLD) {
+        blocks *= 2;
+    }
+    size_t n1 = (m + blocks - 1) / blocks * blocks;
+    size_t pad = n1 - m;
+
+    // a * B^pad and b * B^pad, top block of a is less than b
+    size_t t = std::max<size_t>((n + pad) / n1 + 1, 2);
+    scratch_vector<limb_t> buf(t * n1, 0);
+    scratch_vector<limb_t> divisor(n1, 0);
+    std::copy(a, a + n, buf.begin() + pad);
+    std::copy(b, b + m, divisor.begin() + pad);
+
+    scratch_vector<limb_t> quotient((t - 1) * n1);
+    for (size_t i = t - 1; i > 0; i--) {
+        div_2n_1n(quotient.data() + (i - 1) * n1, buf.data() + (i - 1) * n1, divisor.data(), n1);
+    }
+
+    std::copy(quotient.begin(), quotient.begin() + (n - m), q);
+    std::copy(buf.begin() + pad, buf.begin() + pad + m, a);
+    std::fill(a + m, a + n, 0);
+}
+
+}
+
+void divrem(limb_t* q, limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    if (m == 1) {
+        r[0] = divrem_1(q, a, n, b[0]);
+        return;
+    }
+
+    size_t qn = n - m + 1;
+    if (qn >= BZ_THRESHOLD && m > 2 * qn) {
+        // quotient of the top limbs by the top qn + 2 limbs of b is off by at most one
+        size_t t = m - qn - 2;
+        scratch_vector<limb_t> top_rem(qn + 2);
+        divrem(q, top_rem.data(), a + t, n - t, b + t, m - t);
+
+        scratch_vector<limb_t> rem(n + 1, 0);
+        scratch_vector<limb_t> p(n + 1);
+        std::copy(a, a + n, rem.begin());
+        mul(p.data(), b, m, q, qn);
+        limb_t one = 1;
+        if (sub_n(rem.data(), rem.data(), p.data(), n + 1)) {
+            sub_in(q, qn, &one, 1);
+            add_in(rem.data(), n + 1, b, m);
+        } else if (rem[m] != 0 || compare(rem.data(), b, m) >= 0) {
+            add_in(q, qn, &one, 1);
+            sub_in(rem.data(), n + 1, b, m);
+        }
+        std::copy(rem.begin(), rem.begin() + m, r);
+        return;
+    }
+
+    // normalization: top bit of divisor is set
+    unsigned s = 0;
+    while ((b[m - 1] << s) >> (LIMB_BITS - 1) == 0) {
+        s++;
+    }
+    scratch_vector<limb_t> na(n + 1);
+    scratch_vector<limb_t> nb(b, b + m);
+    std::copy(a, a + n, na.begin());
+    if (s != 0) {
+        na[n] = lshift(na.data(), na.data(), n, s);
+        lshift(nb.data(), nb.data(), m, s);
+    }
+
+    if (m < BZ_THRESHOLD || n - m < BZ_THRESHOLD) {
+        divrem_basecase(q, na.data(), n + 1, nb.data(), m);
+    } else {
+        divrem_recursive(q, na.data(), n + 1, nb.data(), m);
+    }
+
+    if (s != 0) {
+        rshift(na.data(), na.data(), m, s);
+    }
+    std::copy(na.begin(), na.begin() + m, r);
+}
+
+namespace {
+
+// r[0..n+m) = a * b for any n, m > 0
+void mul_any(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    if (n >= m) {
+        mul(r, a, n, b, m);
+    } else {
+        mul(r, b, m, a, n);
+    }
+}
+
+// q[0..n) = a / b modulo B^n for odd b, m <= n, a is destroyed
+void divexact_basecase(limb_t* q, limb_t* a, size_t n, limb_t const* b, size_t m) {
+    limb_t inv = inverse(b[0]);
+    for (size_t i = 0; i < n; i++) {
+        q[i] = a[i] * inv;
+        limb_t borrow = submul_1(a + i, b, std::min(m, n - i), q[i]);
+        for (size_t j = i + m; borrow != 0 && j < n; j++) {
+            limb_t e = a[j];
+            a[j] = e - borrow;
+            borrow = a[j] > e;
+        }
+    }
+}
+
+// x[0..k) = 1 / b modulo B^k for odd b, by Newton iteration x += x * (1 - b * x)
+void hensel_inverse(limb_t* x, limb_t const* b, size_t m, size_t k) {
+    if (k < DIVEXACT_THRESHOLD) {
+        scratch_vector<limb_t> one(k, 0);
+        one[0] = 1;
+        divexact_basecase(x, one.data(), k, b, std::min(m, k));
+        return;
+    }
+
+    // b * x = 1 + B^h * e modulo B^k, so new x = x - B^h * x * e
+    size_t h = (k + 1) / 2;
+    hensel_inverse(x, b, m, h);
+    size_t bm = std::min(m, k);
+    scratch_vector<limb_t> p(std::max(bm + h, k), 0);
+    mul_any(p.data(), b, bm, x, h);
+    scratch_vector<limb_t> y(2 * (k - h));
+    mul_n(y.data(), x, p.data() + h, k - h);
+
+    limb_t carry = 1;
+    for (size_t i = 0; i < k - h; i++) {
+        limb_t e = ~y[i] + carry;
+        carry = carry && e == 0;
+        x[h + i] = e;
+    }
+}
+
+// q[0..qn) = a / b modulo B^qn, b[0..m) divides a[0..n)
+void divexact_low(limb_t* q, limb_t const* a, size_t n, limb_t const* b, size_t m, size_t qn) {
+    // zero limbs and bits of b are also in a, only low qn limbs of both matter after removing them
+    while (b[0] == 0) {
+        a++;
+        b++;
+        n--;
+        m--;
+    }
+    unsigned s = 0;
+    while ((b[0] >> s) % 2 == 0) {
+        s++;
+    }
+    size_t bm = std::min(m, qn);
+    scratch_vector<limb_t> na(qn + 1, 0);
+    scratch_vector<limb_t> nb(bm + 1, 0);
+    std::copy(a, a + std::min(n, qn + 1), na.begin());
+    std::copy(b, b + std::min(m, bm + 1), nb.begin());
+    if (s != 0) {
+        rshift(na.data(), na.data(), qn + 1, s);
+        rshift(nb.data(), nb.data(), bm + 1, s);
+    }
+
+    if (bm < DIVEXACT_THRESHOLD) {
+        divexact_basecase(q, na.data(), qn, nb.data(), bm);
+        return;
+    }
+
+    // quotient by blocks of bm limbs, each block is its low limbs times the inverse of b
+    scratch_vector<limb_t> x(bm);
+    hensel_inverse(x.data(), nb.data(), bm, bm);
+    scratch_vector<limb_t> p(2 * bm);
+    for (size_t lo = 0; lo < qn; lo += bm) {
+        size_t len = std::min(bm, qn - lo);
+        mul_n(p.data(), na.data() + lo, x.data(), len);
+        std::copy(p.begin(), p.begin() + len, q + lo);
+        if (lo + len < qn) {
+            mul_any(p.data(), q + lo, len, nb.data(), bm);
+            sub_in(na.data() + lo, qn - lo, p.data(), std::min(len + bm, qn - lo));
+        }
+    }
+}
+
+}
+
+void divexact(limb_t* q, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    if (m == 1) {
+        divexact_1(q, a, n, b[0]);
+        return;
+    }
+
+    size_t qn = n - m + 1;
+    size_t h = qn / 2;
+    size_t k = qn - h;
+    if (h == 0 || m <= k + 2) {
+        divexact_low(q, a, n, b, m, qn);
+        return;
+    }
+
+    // Jebelean's bidirectional division: low h + 1 limbs of the quotient from the low limbs by Hensel division,
+    // high k limbs by ordinary division of a / B^(h+t) by the top k + 2 limbs b / B^t,
+    // which is off by at most one and is fixed by the overlapping limb
+    scratch_vector<limb_t> low(h + 1);
+    divexact_low(low.data(), a, n, b, m, h + 1);
+
+    size_t t = m - k - 2;
+    scratch_vector<limb_t> rem(k + 2);
+    divrem(q + h, rem.data(), a + h + t, n - h - t, b + t, k + 2);
+    limb_t delta = low[h] - q[h];
+    if (delta == 1) {
+        add_in(q + h, k, &delta, 1);
+    } else if (delta != 0) {
+        limb_t one = 1;
+        sub_in(q + h, k, &one, 1);
+    }
+    std::copy(low.begin(), low.begin() + h, q);
+}
+
+void invert(limb_t* x, limb_t const* d, size_t m) {
+    scratch_vector<limb_t> ones(2 * m, static_cast<limb_t>(-1));
+    scratch_vector<limb_t> q(m + 1);
+    scratch_vector<limb_t> r(m);
+    divrem(q.data(), r.data(), ones.data(), 2 * m, d, m);
+    std::copy(q.begin(), q.begin() + m, x);
+}
+
+namespace {
+
+// Barrett step: q[0..m) = u / d, u[0..2m) < d * B^m is replaced with remainder in u[0..m+1),
+// dd is d padded to m + 1 limbs, p is scratch of 3m + 3 limbs
+void div_preinv_block(limb_t* q, limb_t* u, limb_t const* dd, size_t m, limb_t const* x, limb_t* p) {
+    // (u / B^(m-1)) * (B^m + x) / B^(m+1) is at most two less than the quotient
+    limb_t const* u1 = u + m - 1;
+    mul(p, u1, m + 1, x, m);
+    p[2 * m + 1] = add_in(p + m, m + 1, u1, m + 1);
+    std::copy(p + m + 1, p + 2 * m + 1, q);
+
+    // remainder is less than 3d, so it is enough to compute it modulo B^(m+1)
+    limb_t* qq = p + 2 * m + 2;
+    std::copy(q, q + m, qq);
+    qq[m] = 0;
+    mullo_n(p, qq, dd, m + 1);
+    sub_n(u, u, p, m + 1);
+    limb_t one = 1;
+    while (u[m] != 0 || compare(u, dd, m) >= 0) {
+        add_in(q, m, &one, 1);
+        sub_n(u, u, dd, m + 1);
+    }
+}
+
+}
+
+void divrem_preinv(limb_t* q, limb_t* r, limb_t const* a, size_t n,
+                   limb_t const* d, size_t m, unsigned s, limb_t const* x) {
+    if (m == 1) {
+        r[0] = divrem_1(q, a, n, d[0] >> s);
+        return;
+    }
+
+    scratch_vector<limb_t> na(n + 1, 0);
+    std::copy(a, a + n, na.begin());
+    if (s != 0) {
+        na[n] = lshift(na.data(), na.data(), n, s);
+    }
+
+    if (m < BZ_THRESHOLD || n + 1 - m < BZ_THRESHOLD) {
+        divrem_basecase(q, na.data(), n + 1, d, m);
+    } else {
+        // top m limbs are less than d, the rest is consumed by chunks of m limbs from the top,
+        // every window of remainder and chunk is less than d * B^m
+        scratch_vector<limb_t> u(2 * m);
+        scratch_vector<limb_t> p(3 * m + 3);
+        scratch_vector<limb_t> dd(d, d + m);
+        dd.push_back(0);
+        for (size_t hi = n + 1 - m; hi > 0; ) {
+            size_t len = std::min(m, hi);
+            size_t lo = hi - len;
+            std::copy(na.begin() + lo, na.begin() + lo + len + m, u.begin());
+            if (len == m) {
+                div_preinv_block(q + lo, u.data(), dd.data(), m, x, p.data());
+            } else {
+                // the highest limb of the quotient is zero
+                scratch_vector<limb_t> qt(len + 1);
+                scratch_vector<limb_t> rt(m);
+                divrem(qt.data(), rt.data(), u.data(), len + m, d, m);
+                std::copy(qt.begin(), qt.begin() + len, q + lo);
+                std::copy(rt.begin(), rt.end(), u.begin());
+            }
+            std::copy(u.begin(), u.begin() + m, na.begin() + lo);
+            hi = lo;
+        }
+    }
+
+    if (s != 0) {
+        rshift(na.data(), na.data(), m, s);
+    }
+    std::copy(na.begin(), na.begin() + m, r);
+}
+
+}
@@ -0,0 +1,218 @@
+#include "limbs.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+namespace limbs {
+
+namespace {
+
+const int PIECE_BITS = 32;
+const int PIECES_PER_LIMB = LIMB_BITS / PIECE_BITS;
+
+// arithmetic modulo prime p < 2^30 with values kept in Montgomery form x * 2^32 mod p
+struct ntt_prime {
+    ntt_prime(uint32_t p, uint32_t g)
+        : p(p)
+        , r2(static_cast<uint32_t>((static_cast<uint64_t>(1) << 63) % p * 2 % p))
+        , g(g) {
+        // -p^(-1) mod 2^32
+        uint32_t inv = p;
+        for (int i = 0; i < 4; i++) {
+            inv *= 2 - p * inv;
+        }
+        p_inv_neg = 0 - inv;
+    }
+
+    uint32_t reduce(uint64_t x) const {
+        uint32_t m = static_cast<uint32_t>(x) * p_inv_neg;
+        uint32_t t = static_cast<uint32_t>((x + static_cast<uint64_t>(m) * p) >> 32);
+        return t >= p ? t - p : t;
+    }
+
+    uint32_t mul(uint32_t a, uint32_t b) const {
+        return reduce(static_cast<uint64_t>(a) * b);
+    }
+
+    uint32_t add(uint32_t a, uint32_t b) const {
+        uint32_t r = a + b;
+        return r >= p ? r - p : r;
+    }
+
+    uint32_t sub(uint32_t a, uint32_t b) const {
+        return a >= b ? a - b : a + p - b;
+    }
+
+    uint32_t to_montgomery(uint32_t a) const {
+        return mul(a % p, r2);
+    }
+
+    // a and e in normal form, result in Montgomery form
+    uint32_t pow(uint32_t a, uint64_t e) const {
+        uint32_t res = to_montgomery(1);
+        uint32_t base = to_montgomery(a);
+        for (; e > 0; e >>= 1) {
+            if (e & 1) {
+                res = mul(res, base);
+            }
+            base = mul(base, base);
+        }
+        return res;
+    }
+
+    // roots[len + j] = w^j for primitive 2len-th root w, len = 1, 2, 4, ..., n / 2
+    scratch_vector<uint32_t> roots(size_t n, bool inverse) const {
+        scratch_vector<uint32_t> res(std::max<size_t>(n, 2));
+        for (size_t len = 1; len < n; len *= 2) {
+            uint32_t e = (p - 1) / (2 * len);
+            uint32_t w = pow(g, inverse ? p - 1 - e : e);
+            uint32_t cur = to_montgomery(1);
+            for (size_t j = 0; j < len; j++) {
+                res[len + j] = cur;
+                cur = mul(cur, w);
+            }
+        }
+        return res;
+    }
+
+    // decimation in frequency, output in bit reversed order
+    void forward(uint32_t* a, size_t n, scratch_vector<uint32_t> const& rt) const {
+        for (size_t len = n / 2; len > 0; len /= 2) {
+            for (size_t i = 0; i < n; i += 2 * len) {
+                for (size_t j = 0; j < len; j++) {
+                    uint32_t u = a[i + j];
+                    uint32_t v = a[i + j + len];
+                    a[i + j] = add(u, v);
+                    a[i + j + len] = mul(sub(u, v), rt[len + j]);
+                }
+            }
+        }
+    }
+
+    // decimation in time, input in bit reversed order, result is not divided by n
+    void backward(uint32_t* a, size_t n, scratch_vector<uint32_t> const& rt) const {
+        for (size_t len = 1; len < n; len *= 2) {
+            for (size_t i = 0; i < n; i += 2 * len) {
+                for (size_t j = 0; j < len; j++) {
+                    uint32_t u = a[i + j];
+                    uint32_t v = mul(a[i + j + len], rt[len + j]);
+                    a[i + j] = add(u, v);
+                    a[i + j + len] = sub(u, v);
+                }
+            }
+        }
+    }
+
+    // cyclic convolution of a and b of length n modulo p, result in normal form in res
+    // &a == &b transforms the operand once
+    void convolve(uint32_t* res, scratch_vector<uint32_t> const& a, scratch_vector<uint32_t> const& b, size_t n) const {
+        bool square = &a == &b;
+        scratch_vector<uint32_t> fa(n, 0);
+        scratch_vector<uint32_t> fb(square ? 0 : n, 0);
+        for (size_t i = 0; i < a.size(); i++) {
+            fa[i] = to_montgomery(a[i]);
+        }
+        for (size_t i = 0; !square && i < b.size(); i++) {
+            fb[i] = to_montgomery(b[i]);
+        }
+
+        scratch_vector<uint32_t> rt = roots(n, false);
+        forward(fa.data(), n, rt);
+        if (!square) {
+            forward(fb.data(), n, rt);
+        }
+        uint32_t const* gb = square ? fa.data() : fb.data();
+        for (size_t i = 0; i < n; i++) {
+            fa[i] = mul(fa[i], gb[i]);
+        }
+        backward(fa.data(), n, roots(n, true));
+
+        // Montgomery form of x multiplied by normal form of n^(-1) is normal form of x / n
+        uint32_t n_inv = reduce(pow(static_cast<uint32_t>(n % p), p - 2));
+        for (size_t i = 0; i < n; i++) {
+            res[i] = mul(fa[i], n_inv);
+        }
+    }
+
+    uint32_t p;
+    uint32_t p_inv_neg;
+    uint32_t r2;
+    uint32_t g;
+};
+
+// 7 * 2^26 + 1, 5 * 2^25 + 1, 45 * 2^24 + 1
+const ntt_prime P1(469762049, 3);
+const ntt_prime P2(167772161, 3);
+const ntt_prime P3(754974721, 11);
+
+uint64_t mulmod(uint64_t a, uint64_t b, uint64_t p) {
+    return a * b % p;
+}
+
+uint64_t powmod(uint64_t a, uint64_t e, uint64_t p) {
+    uint64_t res = 1;
+    for (a %= p; e > 0; e >>= 1) {
+        if (e & 1) {
+            res = mulmod(res, a, p);
+        }
+        a = mulmod(a, a, p);
+    }
+    return res;
+}
+
+scratch_vector<uint32_t> to_pieces(limb_t const* a, size_t n) {
+    scratch_vector<uint32_t> res(n * PIECES_PER_LIMB);
+    for (size_t i = 0; i < n; i++) {
+        for (int j = 0; j < PIECES_PER_LIMB; j++) {
+            res[i * PIECES_PER_LIMB + j] = static_cast<uint32_t>(a[i] >> (j * PIECE_BITS));
+        }
+    }
+    return res;
+}
+
+}
+
+void mul_ntt(limb_t* r, limb_t const* a, size_t n, limb_t const* b, size_t m) {
+    bool square = a == b && n == m;
+    scratch_vector<uint32_t> pa = to_pieces(a, n);
+    scratch_vector<uint32_t> pb = square ? scratch_vector<uint32_t>() : to_pieces(b, m);
+    scratch_vector<uint32_t> const& pb_ref = square ? pa : pb;
+    size_t len = 1;
+    while (len < (n + m) * PIECES_PER_LIMB) {
+        len *= 2;
+    }
+
+    scratch_vector<uint32_t> c1(len);
+    scratch_vector<uint32_t> c2(len);
+    scratch_vector<uint32_t> c3(len);
+    P1.convolve(c1.data(), pa, pb_ref, len);
+    P2.convolve(c2.data(), pa, pb_ref, len);
+    P3.convolve(c3.data(), pa, pb_ref, len);
+
+    // Garner's algorithm: x = x1 + p1 * x2 + p1 * p2 * x3
+    uint64_t p1 = P1.p;
+    uint64_t p2 = P2.p;
+    uint64_t p3 = P3.p;
+    uint64_t p1_inv_p2 = powmod(p1, p2 - 2, p2);
+    uint64_t p12_inv_p3 = powmod(p1 * p2 % p3, p3 - 2, p3);
+
+    __uint128_t carry = 0;
+    size_t pieces = (n + m) * PIECES_PER_LIMB;
+    for (size_t i = 0; i < pieces; i++) {
+        uint64_t x1 = c1[i];
+        uint64_t x2 = mulmod((c2[i] + p2 - x1 % p2) % p2, p1_inv_p2, p2);
+        uint64_t x12 = (x1 + p1 * x2) % p3;
+        uint64_t x3 = mulmod((c3[i] + p3 - x12) % p3, p12_inv_p3, p3);
+
+        carry += static_cast<__uint128_t>(p1 * p2) * x3 + p1 * x2 + x1;
+        limb_t& limb = r[i / PIECES_PER_LIMB];
+        if (i % PIECES_PER_LIMB == 0) {
+            limb = 0;
+        }
+        limb |= static_cast<limb_t>(static_cast<uint32_t>(carry)) << (i % PIECES_PER_LIMB * PIECE_BITS);
+        carry >>= PIECE_BITS;
+    }
+}
+
+}
@@ -0,0 +1,80 @@
+#include "memory_resource.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+const size_t ALIGNMENT = alignof(std::max_align_t);
+
+size_t align_up(size_t bytes) {
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+thread_local memory_resource* current_default = nullptr;
+
+}
+
+struct monotonic_resource::chunk {
+    chunk* next;
+};
+
+monotonic_resource::monotonic_resource(size_t chunk_size)
+    : chunks(nullptr)
+    , current(nullptr)
+    , left(0)
+    , next_size(std::max(chunk_size, ALIGNMENT)) {}
+
+monotonic_resource::monotonic_resource(void* initial, size_t size)
+    : monotonic_resource(size) {
+    // skip to the first aligned byte of initial
+    size_t skip = align_up(reinterpret_cast<uintptr_t>(initial)) - reinterpret_cast<uintptr_t>(initial);
+    if (skip < size) {
+        current = static_cast<char*>(initial) + skip;
+        left = size - skip;
+    }
+}
+
+monotonic_resource::~monotonic_resource() {
+    while (chunks != nullptr) {
+        chunk* next = chunks->next;
+        operator delete(chunks);
+        chunks = next;
+    }
+}
+
+void* monotonic_resource::allocate(size_t bytes) {
+    bytes = align_up(bytes);
+    if (bytes > left) {
+        // chunks double, so a long computation makes few of them
+        size_t header = align_up(sizeof(chunk));
+        size_t size = std::max(next_size, bytes + header);
+        chunk* c = static_cast<chunk*>(operator new(size));
+        c->next = chunks;
+        chunks = c;
+        current = reinterpret_cast<char*>(c) + header;
+        left = size - header;
+        next_size = 2 * size;
+    }
+
+    void* res = current;
+    current += bytes;
+    left -= bytes;
+    return res;
+}
+
+void monotonic_resource::deallocate(void*, size_t) {}
+
+memory_resource* default_resource() {
+    return current_default;
+}
+
+scoped_resource::scoped_resource(memory_resource* resource)
+    : previous(current_default) {
+    current_default = resource;
+}
+
+scoped_resource::~scoped_resource() {
+    current_default = previous;
+}
@@ -0,0 +1,94 @@
+#ifndef MEMORY_RESOURCE_H
+#define MEMORY_RESOURCE_H
+
+#include <cstddef>
+#include <new>
+
+// Source of blocks for buffer, a small C++11 counterpart of std::pmr::memory_resource.
+// Blocks are aligned for any scalar type.
+struct memory_resource {
+    virtual ~memory_resource() = default;
+
+    virtual void* allocate(size_t bytes) = 0;
+    // bytes are the ones passed to allocate
+    virtual void deallocate(void* block, size_t bytes) = 0;
+};
+
+// hands out pieces of growing chunks and frees all of them only in its destructor
+struct monotonic_resource : memory_resource {
+    explicit monotonic_resource(size_t chunk_size = 4096);
+    // starts with initial[0..size) owned by the caller, later chunks come from operator new
+    monotonic_resource(void* initial, size_t size);
+    ~monotonic_resource() override;
+
+    monotonic_resource(monotonic_resource const&) = delete;
+    monotonic_resource& operator=(monotonic_resource const&) = delete;
+
+    void* allocate(size_t bytes) override;
+    void deallocate(void* block, size_t bytes) override;
+
+private:
+    struct chunk;
+
+    chunk* chunks;
+    char* current;
+    size_t left;
+    size_t next_size;
+};
+
+// resource of new buffers in this thread, nullptr for operator new
+memory_resource* default_resource();
+
+// allocator of the default resource at its construction, for scratch vectors of the arithmetic;
+// copies of a container take the default resource at the time of the copy
+template <typename T>
+struct resource_allocator {
+    using value_type = T;
+
+    resource_allocator() : resource(default_resource()) {}
+    template <typename U>
+    resource_allocator(resource_allocator<U> const& other) : resource(other.resource) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        return static_cast<T*>(resource == nullptr ? operator new(bytes) : resource->allocate(bytes));
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (resource == nullptr) {
+            operator delete(p);
+        } else {
+            resource->deallocate(p, n * sizeof(T));
+        }
+    }
+
+    resource_allocator select_on_container_copy_construction() const {
+        return resource_allocator();
+    }
+
+    memory_resource* resource;
+};
+
+template <typename T, typename U>
+bool operator==(resource_allocator<T> const& a, resource_allocator<U> const& b) {
+    return a.resource == b.resource;
+}
+
+template <typename T, typename U>
+bool operator!=(resource_allocator<T> const& a, resource_allocator<U> const& b) {
+    return a.resource != b.resource;
+}
+
+// makes resource the default of this thread until its destruction
+struct scoped_resource {
+    explicit scoped_resource(memory_resource* resource);
+    ~scoped_resource();
+
+    scoped_resource(scoped_resource const&) = delete;
+    scoped_resource& operator=(scoped_resource const&) = delete;
+
+private:
+    memory_resource* previous;
+};
+
+#endif // MEMORY_RESOURCE_H
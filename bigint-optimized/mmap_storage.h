@@ -0,0 +1,199 @@
+#ifndef MMAP_STORAGE_H
+#define MMAP_STORAGE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "optimized_storage.h"
+
+// copy-on-write block with the interface of buffer from cow_buffer.h,
+// blocks of at least MMAP_THRESHOLD bytes are anonymous mappings that grow with mremap,
+// a block may also be a private mapping of a file written by save
+template <typename T>
+struct mmap_buffer {
+    static_assert(std::is_trivially_constructible<T>::value, "T should be trivially constructible");
+    static_assert(std::is_trivially_destructible<T>::value, "T should be trivially destructible");
+    static_assert(std::is_trivially_copyable<T>::value, "T should be trivially copyable");
+
+    static const size_t MMAP_THRESHOLD = static_cast<size_t>(1) << 20;
+
+    mmap_buffer() = delete;
+    mmap_buffer(mmap_buffer const&) = delete;
+    mmap_buffer& operator=(mmap_buffer const&) = delete;
+
+    static mmap_buffer* allocate_buffer(size_t cap);
+    static mmap_buffer* allocate_buffer(size_t cap, T const& e);
+
+    mmap_buffer* copy_and_unshare(size_t new_cap, size_t size);
+
+    void unshare();
+    mmap_buffer* share();
+
+    bool not_unique() const;
+
+    // writes values[0..size) with a block header, so that map_file can use the file as a block
+    static void save(std::string const& path, T const* values, size_t size);
+    // maps a file of save copy-on-write, size is set to the number of values in it
+    static mmap_buffer* map_file(std::string const& path, size_t& size);
+
+    size_t count;
+    size_t capacity;
+    // length of the mapping, 0 for blocks from operator new
+    size_t mapped;
+    bool file_backed;
+    T values[];
+
+private:
+    static size_t bytes(size_t cap);
+};
+
+template <typename T>
+size_t mmap_buffer<T>::bytes(size_t cap) {
+    // values may start before the end of the padded struct, so the header ends at their offset
+    return offsetof(mmap_buffer<T>, values) + cap * sizeof(T);
+}
+
+template <typename T>
+mmap_buffer<T>* mmap_buffer<T>::allocate_buffer(size_t cap) {
+    mmap_buffer* res;
+    size_t len = bytes(cap);
+    if (len < MMAP_THRESHOLD) {
+        res = reinterpret_cast<mmap_buffer*>(operator new(len));
+        len = 0;
+    } else {
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        res = static_cast<mmap_buffer*>(p);
+    }
+    res->count = 1;
+    res->capacity = cap;
+    res->mapped = len;
+    res->file_backed = false;
+    return res;
+}
+
+template <typename T>
+mmap_buffer<T>* mmap_buffer<T>::allocate_buffer(size_t cap, T const& e) {
+    mmap_buffer* buf = allocate_buffer(cap);
+    std::fill(buf->values, buf->values + cap, e);
+    return buf;
+}
+
+template <typename T>
+mmap_buffer<T>* mmap_buffer<T>::copy_and_unshare(size_t new_cap, size_t size) {
+#ifdef MREMAP_MAYMOVE
+    // the only owner of an anonymous mapping lets the kernel move the pages instead of copying them
+    if (count == 1 && mapped != 0 && !file_backed && new_cap >= capacity) {
+        size_t len = bytes(new_cap);
+        void* p = mremap(this, mapped, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        mmap_buffer* res = static_cast<mmap_buffer*>(p);
+        res->capacity = new_cap;
+        res->mapped = len;
+        return res;
+    }
+#endif
+
+    mmap_buffer* res = allocate_buffer(new_cap);
+    std::copy(values, values + size, res->values);
+    unshare();
+    return res;
+}
+
+template <typename T>
+void mmap_buffer<T>::unshare() {
+    count--;
+    if (count == 0) {
+        if (mapped != 0) {
+            munmap(this, mapped);
+        } else {
+            operator delete(this);
+        }
+    }
+}
+
+template <typename T>
+mmap_buffer<T>* mmap_buffer<T>::share() {
+    count++;
+    return this;
+}
+
+template <typename T>
+bool mmap_buffer<T>::not_unique() const {
+    return count > 1;
+}
+
+template <typename T>
+void mmap_buffer<T>::save(std::string const& path, T const* values, size_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    // values are written from where they are, without a staging copy
+    alignas(mmap_buffer) char raw[sizeof(mmap_buffer)] = {};
+    mmap_buffer* header = reinterpret_cast<mmap_buffer*>(raw);
+    header->count = 1;
+    header->capacity = size;
+    char const* parts[] = {raw, reinterpret_cast<char const*>(values)};
+    size_t lengths[] = {bytes(0), size * sizeof(T)};
+    for (size_t i = 0; i < 2; i++) {
+        for (size_t done = 0; done < lengths[i]; ) {
+            ssize_t res = write(fd, parts[i] + done, lengths[i] - done);
+            if (res < 0) {
+                close(fd);
+                throw std::runtime_error("Cannot write " + path);
+            }
+            done += static_cast<size_t>(res);
+        }
+    }
+    close(fd);
+}
+
+template <typename T>
+mmap_buffer<T>* mmap_buffer<T>::map_file(std::string const& path, size_t& size) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < bytes(1)) {
+        close(fd);
+        throw std::runtime_error("Not a saved storage file: " + path);
+    }
+
+    size_t len = static_cast<size_t>(st.st_size);
+    void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+
+    mmap_buffer* res = static_cast<mmap_buffer*>(p);
+    if (bytes(res->capacity) != len) {
+        munmap(p, len);
+        throw std::runtime_error("Not a saved storage file: " + path);
+    }
+    // only the page with the header becomes a private copy
+    res->count = 1;
+    res->mapped = len;
+    res->file_backed = true;
+    size = res->capacity;
+    return res;
+}
+
+template <typename T, size_t N = 2 * sizeof(void*) / sizeof(T)>
+using mmap_storage = optimized_storage<T, N, mmap_buffer>;
+
+#endif // MMAP_STORAGE_H
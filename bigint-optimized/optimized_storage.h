@@ -6,18 +6,37 @@
 #include <vector>
 #include "cow_buffer.h"
 
-template <typename T>
+// N values are kept inline, by default as many as make the storage three words long,
+// Buffer is the copy-on-write heap block for more values, see buffer in cow_buffer.h.
+// With BIG_INTEGER_MEMORY_RESOURCE the storage keeps the resource of its construction
+// and takes every block from it, like the containers of std::pmr
+template <typename T, size_t N = 2 * sizeof(void*) / sizeof(T),
+          template <typename> class Buffer = single_thread_buffer>
 struct optimized_storage {
     static_assert(std::is_trivially_constructible<T>::value, "T should be trivially constructible");
     static_assert(std::is_trivially_destructible<T>::value, "T should be trivially destructible");
     static_assert(std::is_trivially_copyable<T>::value, "T should be trivially copyable");
+    static_assert(N > 0, "N should be positive");
 
     optimized_storage(size_t size, T const& value);
+    // takes the ownership of buf holding size values
+    optimized_storage(Buffer<T>* buf, size_t size);
     ~optimized_storage();
 
     optimized_storage(optimized_storage const&);
     optimized_storage& operator=(optimized_storage const&);
-
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // copy of other with blocks of resource, the block of other is shared only if it came from resource
+    optimized_storage(optimized_storage const& other, memory_resource* resource);
+#endif
+    // other is left empty, the resource goes with the values
+    optimized_storage(optimized_storage&& other) noexcept;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    // copies the values if other has another resource
+    optimized_storage& operator=(optimized_storage&& other);
+#else
+    optimized_storage& operator=(optimized_storage&& other) noexcept;
+#endif
 
     T const& operator[](size_t) const;
     T& operator[](size_t);
@@ -32,185 +51,294 @@ struct optimized_storage {
     void resize(size_t, T const&);
 
     size_t size() const;
+    // values that fit without a reallocation
+    size_t capacity() const;
 
-    void swap(optimized_storage &);
+    // the resources are swapped with the values
+    void swap(optimized_storage &) noexcept;
 
 private:
-    void become_big(buffer<T>* new_buffer);
+    Buffer<T>* make_buffer(size_t cap) const;
+    void become_big(Buffer<T>* new_buffer);
     void become_big(size_t cap, T const& value);
     void become_big(size_t cap);
 
-    static constexpr size_t SMALL_SIZE = sizeof(buffer<T>*) / sizeof(T);
+    bool is_small_object() const;
+    void set_size(size_t);
+
+    static constexpr size_t SMALL_SIZE = N;
+    static constexpr size_t BIG_FLAG = 1;
 
-    size_t size_;
-    bool is_small_object;
+    // size shifted left by one, BIG_FLAG is set while the values are in shared.buf
+    size_t size_and_flag;
 
     union {
-        buffer<T>* buf;
+        Buffer<T>* buf;
         T values[SMALL_SIZE];
     } shared;
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    memory_resource* resource = default_resource();
+#endif
 };
 
-template <typename T>
-optimized_storage<T>::optimized_storage(size_t size, T const& value)
-    : size_(size)
-    , is_small_object(size <= SMALL_SIZE) {
-    if (is_small_object) {
-        std::fill(shared.values, shared.values + size_, value);
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(size_t size, T const& value)
+    : size_and_flag(size << 1) {
+    if (size <= SMALL_SIZE) {
+        std::fill(shared.values, shared.values + size, value);
     } else {
-        shared.buf = buffer<T>::allocate_buffer(size_, value);
+        shared.buf = make_buffer(size);
+        std::fill(shared.buf->values, shared.buf->values + size, value);
+        size_and_flag |= BIG_FLAG;
     }
 }
 
-template <typename T>
-optimized_storage<T>::optimized_storage(optimized_storage const& other)
-    : size_(other.size_)
-    , is_small_object(other.size_ <= SMALL_SIZE) {
-    if (is_small_object) {
-        if (other.is_small_object) {
-            std::copy(other.shared.values, other.shared.values + size_, shared.values);
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(Buffer<T>* buf, size_t size)
+    : size_and_flag(size << 1 | BIG_FLAG)
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    , resource(buf->resource)
+#endif
+{
+    shared.buf = buf;
+}
+
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(optimized_storage const& other)
+    : optimized_storage(other, default_resource()) {}
+#else
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(optimized_storage const& other)
+    : size_and_flag(other.size() << 1) {
+    if (other.size() <= SMALL_SIZE) {
+        if (other.is_small_object()) {
+            std::copy(other.shared.values, other.shared.values + other.size(), shared.values);
         } else {
-            std::copy(other.shared.buf->values, other.shared.buf->values + size_, shared.values);
+            std::copy(other.shared.buf->values, other.shared.buf->values + other.size(), shared.values);
         }
     } else {
         shared.buf = other.shared.buf->share();
+        size_and_flag |= BIG_FLAG;
     }
 }
+#endif
+
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(optimized_storage const& other, memory_resource* resource)
+    : size_and_flag(other.size() << 1)
+    , resource(resource) {
+    T const* first = other.is_small_object() ? other.shared.values : other.shared.buf->values;
+    if (other.size() <= SMALL_SIZE) {
+        std::copy(first, first + other.size(), shared.values);
+    } else if (other.shared.buf->resource == resource) {
+        shared.buf = other.shared.buf->share();
+        size_and_flag |= BIG_FLAG;
+    } else {
+        shared.buf = Buffer<T>::allocate_buffer(resource, other.size());
+        std::copy(first, first + other.size(), shared.buf->values);
+        size_and_flag |= BIG_FLAG;
+    }
+}
+#endif
+
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::optimized_storage(optimized_storage&& other) noexcept
+    : size_and_flag(other.size_and_flag)
+    , shared(other.shared)
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    , resource(other.resource)
+#endif
+{
+    other.size_and_flag = 0;
+}
 
-template <typename T>
-optimized_storage<T>::~optimized_storage() {
-    if (!is_small_object) {
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>::~optimized_storage() {
+    if (!is_small_object()) {
         shared.buf->unshare();
     }
 }
 
-template <typename T>
-optimized_storage<T>& optimized_storage<T>::operator=(optimized_storage const& other) {
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>& optimized_storage<T, N, Buffer>::operator=(optimized_storage const& other) {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    optimized_storage copy(other, resource);
+#else
     optimized_storage copy(other);
+#endif
     swap(copy);
     return *this;
 }
 
-template <typename T>
-T const& optimized_storage<T>::operator[](size_t i) const {
-    return is_small_object ? shared.values[i] : shared.buf->values[i];
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>& optimized_storage<T, N, Buffer>::operator=(optimized_storage&& other) {
+    if (resource != other.resource) {
+        return *this = static_cast<optimized_storage const&>(other);
+    }
+    swap(other);
+    return *this;
+}
+#else
+template <typename T, size_t N, template <typename> class Buffer>
+optimized_storage<T, N, Buffer>& optimized_storage<T, N, Buffer>::operator=(optimized_storage&& other) noexcept {
+    swap(other);
+    return *this;
+}
+#endif
+
+template <typename T, size_t N, template <typename> class Buffer>
+T const& optimized_storage<T, N, Buffer>::operator[](size_t i) const {
+    return is_small_object() ? shared.values[i] : shared.buf->values[i];
 }
 
-template <typename T>
-T& optimized_storage<T>::operator[](size_t i) {
-    if (is_small_object) {
+template <typename T, size_t N, template <typename> class Buffer>
+T& optimized_storage<T, N, Buffer>::operator[](size_t i) {
+    if (is_small_object()) {
         return shared.values[i];
     }
 
     if (shared.buf->not_unique()) {
-        shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity, size_);
+        shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity, size());
     }
     return shared.buf->values[i];
 }
 
-template <typename T>
-T const& optimized_storage<T>::back() const {
-    return (*this)[size_ - 1];
+template <typename T, size_t N, template <typename> class Buffer>
+T const& optimized_storage<T, N, Buffer>::back() const {
+    return (*this)[size() - 1];
 }
 
-template <typename T>
-T& optimized_storage<T>::back() {
-    return (*this)[size_ - 1];
+template <typename T, size_t N, template <typename> class Buffer>
+T& optimized_storage<T, N, Buffer>::back() {
+    return (*this)[size() - 1];
 }
 
-template <typename T>
-void optimized_storage<T>::push_back(T const& e) {
-    if ((is_small_object && size_ == SMALL_SIZE) ||
-            (!is_small_object && (size_ == shared.buf->capacity || shared.buf->not_unique()))) {
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::push_back(T const& e) {
+    size_t length = size();
+    if ((is_small_object() && length == SMALL_SIZE) ||
+            (!is_small_object() && (length == shared.buf->capacity || shared.buf->not_unique()))) {
         T copy(e);
 
-        if (is_small_object) {
-            // size_ == SMALL_SIZE from first if
+        if (is_small_object()) {
+            // length == SMALL_SIZE from first if
             become_big(SMALL_SIZE * 2);
-        } else if (size_ == shared.buf->capacity) {
-            shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity == 0 ? 1 : 2 * shared.buf->capacity, size_);
+        } else if (length == shared.buf->capacity) {
+            shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity == 0 ? 1 : 2 * shared.buf->capacity, length);
         } else {
             // shared.buf not unique
-            shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity, size_);
+            shared.buf = shared.buf->copy_and_unshare(shared.buf->capacity, length);
         }
-        new(shared.buf->values + size_) T(copy);
+        new(shared.buf->values + length) T(copy);
     } else {
-        new((is_small_object ? shared.values : shared.buf->values) + size_) T(e);
+        new((is_small_object() ? shared.values : shared.buf->values) + length) T(e);
     }
 
-    size_++;
+    set_size(length + 1);
 }
 
-template <typename T>
-void optimized_storage<T>::pop_back() {
-    size_--;
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::pop_back() {
+    set_size(size() - 1);
 }
 
-template <typename T>
-void optimized_storage<T>::assign(size_t size, T value) {
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::assign(size_t size, T value) {
     resize(size, value);
-    if (is_small_object) {
+    if (is_small_object()) {
         std::fill(shared.values, shared.values + size, value);
     } else {
         if (shared.buf->not_unique()) {
-            shared.buf = shared.buf->copy_and_unshare(size, size_);
+            shared.buf = shared.buf->copy_and_unshare(size, size);
         }
         std::fill(shared.buf->values, shared.buf->values + size, value);
     }
 }
 
-template <typename T>
-void optimized_storage<T>::resize(size_t size, T const& value) {
-    if (is_small_object) {
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::resize(size_t size, T const& value) {
+    size_t length = this->size();
+    if (is_small_object()) {
         if (size <= SMALL_SIZE) {
-            if (size_ < size) {
-                std::fill(shared.values + size_, shared.values + size, value);
+            if (length < size) {
+                std::fill(shared.values + length, shared.values + size, value);
             }
         } else {
             become_big(size, value);
         }
     } else {
-        // if buf should increase capacity OR we have to copy buf to fill size_..size with value
-        if (size > shared.buf->capacity || (size > size_ && shared.buf->not_unique())) {
-            // size > shared.buf->capacity ==> size > size_
+        // if buf should increase capacity OR we have to copy buf to fill length..size with value
+        if (size > shared.buf->capacity || (size > length && shared.buf->not_unique())) {
+            // size > shared.buf->capacity ==> size > length
             T copy(value);
-            shared.buf = shared.buf->copy_and_unshare(std::max(size, shared.buf->capacity), size_);
-            std::fill(shared.buf->values + size_, shared.buf->values + size, copy);
-        } else if (size > size_) {
-            std::fill(shared.buf->values + size_, shared.buf->values + size, value);
+            shared.buf = shared.buf->copy_and_unshare(std::max(size, shared.buf->capacity), length);
+            std::fill(shared.buf->values + length, shared.buf->values + size, copy);
+        } else if (size > length) {
+            std::fill(shared.buf->values + length, shared.buf->values + size, value);
         }
     }
 
-    size_ = size;
+    set_size(size);
+}
+
+template <typename T, size_t N, template <typename> class Buffer>
+size_t optimized_storage<T, N, Buffer>::size() const {
+    return size_and_flag >> 1;
 }
 
-template <typename T>
-size_t optimized_storage<T>::size() const {
-    return size_;
+template <typename T, size_t N, template <typename> class Buffer>
+size_t optimized_storage<T, N, Buffer>::capacity() const {
+    return is_small_object() ? SMALL_SIZE : shared.buf->capacity;
 }
 
-template <typename T>
-void optimized_storage<T>::swap(optimized_storage &other) {
-    std::swap(size_, other.size_);
-    std::swap(is_small_object, other.is_small_object);
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::swap(optimized_storage &other) noexcept {
+    std::swap(size_and_flag, other.size_and_flag);
     std::swap(shared, other.shared);
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    std::swap(resource, other.resource);
+#endif
+}
+
+template <typename T, size_t N, template <typename> class Buffer>
+bool optimized_storage<T, N, Buffer>::is_small_object() const {
+    return (size_and_flag & BIG_FLAG) == 0;
+}
+
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::set_size(size_t size) {
+    size_and_flag = size << 1 | (size_and_flag & BIG_FLAG);
+}
+
+template <typename T, size_t N, template <typename> class Buffer>
+Buffer<T>* optimized_storage<T, N, Buffer>::make_buffer(size_t cap) const {
+#ifdef BIG_INTEGER_MEMORY_RESOURCE
+    return Buffer<T>::allocate_buffer(resource, cap);
+#else
+    return Buffer<T>::allocate_buffer(cap);
+#endif
 }
 
-template <typename T>
-void optimized_storage<T>::become_big(buffer<T> *new_buffer) {
-    std::copy(shared.values, shared.values + size_, new_buffer->values);
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::become_big(Buffer<T> *new_buffer) {
+    std::copy(shared.values, shared.values + size(), new_buffer->values);
     shared.buf = new_buffer;
-    is_small_object = false;
+    size_and_flag |= BIG_FLAG;
 }
 
-template <typename T>
-void optimized_storage<T>::become_big(size_t cap, T const& value) {
-    become_big(buffer<T>::allocate_buffer(cap, value));
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::become_big(size_t cap, T const& value) {
+    Buffer<T>* buf = make_buffer(cap);
+    std::fill(buf->values, buf->values + cap, value);
+    become_big(buf);
 }
 
-template <typename T>
-void optimized_storage<T>::become_big(size_t cap) {
-    become_big(buffer<T>::allocate_buffer(cap));
+template <typename T, size_t N, template <typename> class Buffer>
+void optimized_storage<T, N, Buffer>::become_big(size_t cap) {
+    become_big(make_buffer(cap));
 }
 
 #endif // OPTIMIZED_STORAGE_H
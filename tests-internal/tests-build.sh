@@ -1,7 +1,7 @@
 #!/bin/bash
 
-mkdir cmake-build-$1
+mkdir -p cmake-build-$1
 cd cmake-build-$1
-cmake .. -DCMAKE_BUILD_TYPE=$1
+cmake .. -DCMAKE_BUILD_TYPE=$1 "${@:3}"
 make
 ./$2